@@ -0,0 +1,826 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "client/chunk_column.hpp"
+#include "client/chunk_mesh.hpp"
+#include "client/chunk_mesh_cache.hpp"
+#include "client/chunk_mesh_pool.hpp"
+#include "client/chunk_neighborhood.hpp"
+#include "client/common.hpp"
+#include "client/light_engine.hpp"
+#include "client/light_scheduler.hpp"
+#include "client/lighting.hpp"
+#include "client/save_file.hpp"
+#include "client/world_data.hpp"
+#include "client/world_generator.hpp"
+
+#include <nnm/nnm.hpp>
+
+// Headless benchmarks of world generation, lighting, meshing and saving over a fixed seed region. Results are written
+// as JSON and can be compared against an earlier run to catch regressions:
+//   voxelverse_bench [--radius <columns>] [--repeat <runs>] [--threads <max>] [--out <file>] [--baseline <file>]
+
+using json = nlohmann::json;
+
+static std::atomic<uint64_t> g_allocation_count = 0;
+static std::atomic<uint64_t> g_allocated_bytes = 0;
+
+static void* counted_alloc(const size_t size, const size_t alignment)
+{
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void* ptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(size == 0 ? 1 : size);
+    }
+    else {
+        // aligned_alloc requires the size to be a multiple of the alignment
+        ptr = std::aligned_alloc(alignment, (std::max(size, size_t(1)) + alignment - 1) / alignment * alignment);
+    }
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+// GCC pairs the replaced operator new below with the malloc/free it forwards to and reports every delete as
+// mismatched. Every allocation here is released through std::free, so the warning is a false positive
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(const size_t size)
+{
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void* operator new[](const size_t size)
+{
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+    return counted_alloc(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment)
+{
+    return counted_alloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+static constexpr int sc_seed = 1;
+// Edits are made two columns in from the edge so their light stays within the region
+static constexpr int sc_min_radius = 2;
+static constexpr size_t sc_voxels_per_chunk = 16 * 16 * 16;
+static constexpr size_t sc_light_edit_count = 200;
+// Benchmarks that run this much slower than the baseline fail the run
+static constexpr double sc_regression_tolerance = 0.1;
+
+struct Sample {
+    std::chrono::nanoseconds time {};
+    uint64_t allocation_count = 0;
+    uint64_t allocated_bytes = 0;
+};
+
+struct BenchResult {
+    std::string name;
+    // Chunks processed by one run
+    size_t chunk_count = 0;
+    // Block edits made by one run, for benchmarks of edits rather than of whole chunks
+    size_t edit_count = 0;
+    // Threads the work was spread over, for benchmarks of LightScheduler
+    size_t thread_count = 0;
+    // Vertices of the meshes made by one run, for meshing benchmarks
+    size_t vertex_count = 0;
+    // Lookups made by one run, for benchmarks of single voxel queries
+    size_t query_count = 0;
+    // Faces handled by one run, for benchmarks of per-face work
+    size_t face_count = 0;
+    // Fastest of the runs
+    Sample sample {};
+};
+
+template <typename Func>
+static Sample measure(Func&& func)
+{
+    const uint64_t allocation_count = g_allocation_count.load(std::memory_order_relaxed);
+    const uint64_t allocated_bytes = g_allocated_bytes.load(std::memory_order_relaxed);
+    const auto begin = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    return { .time = end - begin,
+             .allocation_count = g_allocation_count.load(std::memory_order_relaxed) - allocation_count,
+             .allocated_bytes = g_allocated_bytes.load(std::memory_order_relaxed) - allocated_bytes };
+}
+
+static void keep_fastest(BenchResult& result, const Sample& sample)
+{
+    if (result.sample.time == std::chrono::nanoseconds::zero() || sample.time < result.sample.time) {
+        result.sample = sample;
+    }
+}
+
+template <typename Func>
+static BenchResult run_bench(std::string name, const size_t chunk_count, const int repeat, Func&& func)
+{
+    BenchResult result { .name = std::move(name), .chunk_count = chunk_count };
+    for (int i = 0; i < repeat; ++i) {
+        keep_fastest(result, measure(func));
+    }
+    return result;
+}
+
+static std::vector<nnm::Vector2i> columns_within(const int radius)
+{
+    std::vector<nnm::Vector2i> columns;
+    for_2d({ -radius, -radius }, { radius + 1, radius + 1 }, [&](const nnm::Vector2i pos) { columns.push_back(pos); });
+    return columns;
+}
+
+static std::vector<nnm::Vector3i> chunks_of(const std::vector<nnm::Vector2i>& columns)
+{
+    std::vector<nnm::Vector3i> chunks;
+    for (const nnm::Vector2i col : columns) {
+        for (int h = -10; h < 10; ++h) {
+            chunks.emplace_back(col.x, col.y, h);
+        }
+    }
+    return chunks;
+}
+
+// Average resident size of the columns against the two flat 4 KiB block and light arrays every chunk used to hold
+static json column_memory(const WorldData& world_data, const std::vector<nnm::Vector2i>& columns)
+{
+    size_t total = 0;
+    for (const nnm::Vector2i col : columns) {
+        total += world_data.chunk_column_data_at(col).memory_usage();
+    }
+    const double bytes_per_column = static_cast<double>(total) / static_cast<double>(columns.size());
+    const auto flat_bytes_per_column = static_cast<double>(sizeof(ChunkColumn) + 20 * 2 * sc_voxels_per_chunk);
+    return { { "bytes_per_column", bytes_per_column },
+             { "flat_bytes_per_column", flat_bytes_per_column },
+             { "ratio_to_flat", bytes_per_column / flat_bytes_per_column } };
+}
+
+// Block positions spread evenly over the columns
+static std::vector<nnm::Vector3i> random_block_positions(const std::vector<nnm::Vector2i>& columns, const size_t count)
+{
+    std::mt19937 random(sc_seed);
+    std::uniform_int_distribution<size_t> column_dist(0, columns.size() - 1);
+    std::uniform_int_distribution<int> local_dist(0, 15);
+    std::uniform_int_distribution<int> z_dist(-10 * 16, 10 * 16 - 1);
+    std::vector<nnm::Vector3i> positions;
+    positions.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const nnm::Vector2i col = columns[column_dist(random)];
+        positions.emplace_back(col.x * 16 + local_dist(random), col.y * 16 + local_dist(random), z_dist(random));
+    }
+    return positions;
+}
+
+// Every voxel of the chunks in memory order, the way neighbouring queries walk through a chunk
+static std::vector<nnm::Vector3i> coherent_block_positions(const std::vector<nnm::Vector3i>& chunks)
+{
+    std::vector<nnm::Vector3i> positions;
+    positions.reserve(chunks.size() * sc_voxels_per_chunk);
+    for (const nnm::Vector3i chunk_pos : chunks) {
+        for_3d({ 0, 0, 0 }, { 16, 16, 16 }, [&](const nnm::Vector3i local_pos) {
+            positions.push_back(block_local_to_world(chunk_pos, local_pos));
+        });
+    }
+    return positions;
+}
+
+// Generates every column within radius of the origin in a new world, there must be no save to load them from
+static std::unique_ptr<WorldData> generate_world(const WorldGenerator& generator, const int radius)
+{
+    auto world_data = std::make_unique<WorldData>();
+    for (const nnm::Vector2i col : columns_within(radius)) {
+        world_data->create_or_load_chunk(col);
+        generator.generate_chunk(*world_data, col);
+    }
+    return world_data;
+}
+
+struct BlockEdit {
+    nnm::Vector3i pos;
+    uint8_t block;
+};
+
+// Places and breaks of stone, leaves and lamps around the terrain surface of the columns
+static std::vector<BlockEdit> random_edits(
+    const WorldGenerator& generator, const std::vector<nnm::Vector2i>& columns, const size_t count)
+{
+    constexpr std::array<uint8_t, 4> blocks { 0, 2, 9, 10 };
+    std::mt19937 random(sc_seed);
+    std::uniform_int_distribution<size_t> column_dist(0, columns.size() - 1);
+    std::uniform_int_distribution<int> local_dist(0, 15);
+    std::uniform_int_distribution<int> depth_dist(-12, 6);
+    std::uniform_int_distribution<size_t> block_dist(0, blocks.size() - 1);
+    std::vector<BlockEdit> edits;
+    for (size_t i = 0; i < count; ++i) {
+        const nnm::Vector2i block_col
+            = columns[column_dist(random)] * 16 + nnm::Vector2i(local_dist(random), local_dist(random));
+        const int surface = static_cast<int>(nnm::ceil(generator.terrain_height(block_col)));
+        edits.push_back({ .pos = { block_col.x, block_col.y, surface + depth_dist(random) },
+                          .block = blocks[block_dist(random)] });
+    }
+    return edits;
+}
+
+// Sets the blocks and relights each one with relight(block_pos, old_block). Returns the edits undoing them.
+template <typename Relight>
+static std::vector<BlockEdit> apply_edits(WorldData& world_data, const std::vector<BlockEdit>& edits, Relight&& relight)
+{
+    std::vector<BlockEdit> undo;
+    undo.reserve(edits.size());
+    for (const auto& [pos, block] : edits) {
+        const uint8_t old_block = *world_data.block_at(pos);
+        world_data.set_block(pos, block);
+        relight(pos, old_block);
+        undo.push_back({ .pos = pos, .block = old_block });
+    }
+    std::ranges::reverse(undo);
+    return undo;
+}
+
+// Packed sky and block light of every voxel of the chunks
+static std::vector<uint8_t> light_of(const WorldData& world_data, const std::vector<nnm::Vector3i>& chunks)
+{
+    std::vector<uint8_t> light;
+    light.reserve(chunks.size() * sc_voxels_per_chunk);
+    for (const nnm::Vector3i chunk_pos : chunks) {
+        const LightStorage& lighting = world_data.chunk_data_at(chunk_pos).lighting();
+        for (size_t i = 0; i < sc_voxels_per_chunk; ++i) {
+            light.push_back(lighting.packed(i));
+        }
+    }
+    return light;
+}
+
+static size_t count_differences(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b)
+{
+    size_t difference_count = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        difference_count += a[i] != b[i] ? 1 : 0;
+    }
+    return difference_count;
+}
+
+// Voxels whose light differs from a relight of the world from scratch, which leaves the world relit
+static size_t count_light_mismatches(WorldData& world_data, const std::vector<nnm::Vector2i>& columns)
+{
+    const std::vector<nnm::Vector3i> chunks = chunks_of(columns);
+    const std::vector<uint8_t> light = light_of(world_data, chunks);
+    relight_columns(world_data, columns);
+    return count_differences(light, light_of(world_data, chunks));
+}
+
+// Powers of two below max_threads followed by max_threads
+static std::vector<size_t> thread_counts_up_to(const size_t max_threads)
+{
+    std::vector<size_t> counts;
+    for (size_t count = 1; count < max_threads; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+static json to_json(const BenchResult& result)
+{
+    const auto time_ns = static_cast<double>(result.sample.time.count());
+    json output { { "name", result.name },
+                  { "time_ns", result.sample.time.count() },
+                  { "allocations", result.sample.allocation_count },
+                  { "allocated_bytes", result.sample.allocated_bytes } };
+    if (result.chunk_count > 0) {
+        const auto chunk_count = static_cast<double>(result.chunk_count);
+        output["chunks"] = result.chunk_count;
+        output["chunks_per_s"] = time_ns > 0.0 ? chunk_count * 1e9 / time_ns : 0.0;
+        output["ns_per_voxel"] = time_ns / (chunk_count * sc_voxels_per_chunk);
+    }
+    if (result.edit_count > 0) {
+        output["edits"] = result.edit_count;
+        output["ns_per_edit"] = time_ns / static_cast<double>(result.edit_count);
+    }
+    if (result.thread_count > 0) {
+        output["threads"] = result.thread_count;
+    }
+    if (result.query_count > 0) {
+        output["queries"] = result.query_count;
+        output["ns_per_query"] = time_ns / static_cast<double>(result.query_count);
+    }
+    if (result.face_count > 0) {
+        output["faces"] = result.face_count;
+        output["ns_per_face"] = time_ns / static_cast<double>(result.face_count);
+    }
+    if (result.vertex_count > 0) {
+        output["vertices"] = result.vertex_count;
+        output["vertices_per_chunk"]
+            = static_cast<double>(result.vertex_count) / static_cast<double>(result.chunk_count);
+    }
+    return output;
+}
+
+// Vertex count and time of every other meshing benchmark relative to naive meshing of the same chunks
+static json compare_meshing_to_naive(const std::vector<BenchResult>& results)
+{
+    const auto naive = std::ranges::find(results, "create_chunk_buffer_data_naive", &BenchResult::name);
+    json comparison = json::object();
+    for (const BenchResult& result : results) {
+        if (result.vertex_count == 0 || &result == &*naive) {
+            continue;
+        }
+        comparison[result.name]
+            = { { "vertex_ratio", static_cast<double>(result.vertex_count) / static_cast<double>(naive->vertex_count) },
+                { "time_ratio",
+                  static_cast<double>(result.sample.time.count())
+                      / static_cast<double>(naive->sample.time.count()) } };
+    }
+    return comparison;
+}
+
+// Whether json is an object holding a benchmark array, every benchmark naming itself and giving a positive time
+static bool is_valid_results(const json& results)
+{
+    if (!results.is_object() || !results.contains("radius") || !results.contains("benchmarks")
+        || !results.at("benchmarks").is_array()) {
+        return false;
+    }
+    return std::ranges::all_of(results.at("benchmarks"), [](const json& result) {
+        return result.is_object() && result.contains("name") && result.at("name").is_string()
+            && result.contains("time_ns") && result.at("time_ns").is_number()
+            && result.at("time_ns").get<double>() > 0.0 && result.contains("allocations")
+            && result.at("allocations").is_number_integer();
+    });
+}
+
+// Prints how every benchmark compares to the same one in baseline, returns false if any got slower than the tolerance
+static bool compare_to_baseline(const json& results, const json& baseline)
+{
+    if (!is_valid_results(baseline)) {
+        std::cerr << "[Bench] Baseline is not a voxelverse_bench result\n";
+        return false;
+    }
+    if (baseline.at("radius") != results.at("radius")) {
+        std::cerr << "[Bench] Baseline was run with a different radius\n";
+        return false;
+    }
+    bool passed = true;
+    for (const json& result : results.at("benchmarks")) {
+        for (const json& base : baseline.at("benchmarks")) {
+            if (base.at("name") != result.at("name")) {
+                continue;
+            }
+            const double ratio = result.at("time_ns").get<double>() / base.at("time_ns").get<double>();
+            const bool regressed = ratio > 1.0 + sc_regression_tolerance;
+            std::cerr << result.at("name").get<std::string>() << ": " << ratio << "x baseline time, " << std::showpos
+                      << result.at("allocations").get<int64_t>() - base.at("allocations").get<int64_t>()
+                      << std::noshowpos << " allocations" << (regressed ? " REGRESSED" : "") << "\n";
+            passed = passed && !regressed;
+        }
+    }
+    return passed;
+}
+
+static void print_usage()
+{
+    std::cerr << "Usage: voxelverse_bench [--radius <columns>] [--repeat <runs>] [--threads <max>] [--out <file>] "
+                 "[--baseline <file>]\n";
+}
+
+int main(const int argc, char* argv[])
+{
+    int radius = 4;
+    int repeat = 3;
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string out_path;
+    std::string baseline_path;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return EXIT_SUCCESS;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "[Bench] Missing value for " << arg << "\n";
+            print_usage();
+            return EXIT_FAILURE;
+        }
+        if (arg == "--radius") {
+            radius = std::max(sc_min_radius, std::atoi(argv[i + 1]));
+        }
+        else if (arg == "--repeat") {
+            repeat = std::max(1, std::atoi(argv[i + 1]));
+        }
+        else if (arg == "--threads") {
+            max_threads = static_cast<size_t>(std::max(1, std::atoi(argv[i + 1])));
+        }
+        else if (arg == "--out") {
+            out_path = std::filesystem::absolute(argv[i + 1]).string();
+        }
+        else if (arg == "--baseline") {
+            baseline_path = std::filesystem::absolute(argv[i + 1]).string();
+        }
+        else {
+            std::cerr << "[Bench] Unknown argument " << arg << "\n";
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Saves are written relative to the working directory
+    const std::filesystem::path work_dir = std::filesystem::temp_directory_path() / "voxelverse_bench";
+    std::filesystem::remove_all(work_dir);
+    std::filesystem::create_directories(work_dir);
+    std::filesystem::current_path(work_dir);
+
+    const WorldGenerator generator(sc_seed);
+    // Generating a column also generates terrain in its neighbours so those are not counted
+    const std::vector<nnm::Vector2i> columns = columns_within(radius);
+    // Lighting and meshing read the neighbours of a chunk so only the inner columns are complete
+    const std::vector<nnm::Vector3i> inner_chunks = chunks_of(columns_within(radius - 1));
+
+    std::vector<BenchResult> results;
+    // Set if the ChunkMap and std::unordered_map lookups disagree, which would make their timings meaningless
+    bool block_query_mismatch = false;
+
+    BenchResult generate { .name = "generate_chunk", .chunk_count = columns.size() * 20 };
+    std::unique_ptr<WorldData> world_data;
+    for (int i = 0; i < repeat; ++i) {
+        // The previous world saves its columns on destruction
+        world_data.reset();
+        std::filesystem::remove_all("save");
+        keep_fastest(generate, measure([&] { world_data = generate_world(generator, radius); }));
+    }
+    results.push_back(std::move(generate));
+
+    results.push_back(run_bench("apply_sunlight", columns.size() * 20, repeat, [&] {
+        for (const nnm::Vector2i col : columns) {
+            apply_sunlight(world_data->chunk_column_data_at(col));
+        }
+    }));
+
+    results.push_back(run_bench("refresh_lighting", inner_chunks.size(), repeat, [&] {
+        for (const nnm::Vector3i chunk_pos : inner_chunks) {
+            refresh_lighting(*world_data, chunk_pos);
+        }
+    }));
+
+    {
+        // The columns used to be in a std::unordered_map that block_at looked up twice, with contains then at
+        std::unordered_map<nnm::Vector2i, const ChunkColumn*> column_map;
+        for (const nnm::Vector2i col : columns) {
+            column_map.emplace(col, &world_data->chunk_column_data_at(col));
+        }
+        auto unordered_map_block_at = [&](const nnm::Vector3i block_pos) -> std::optional<uint8_t> {
+            const nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(block_pos);
+            if (chunk_pos.z < -10 || chunk_pos.z >= 10) {
+                return {};
+            }
+            if (!column_map.contains({ chunk_pos.x, chunk_pos.y })) {
+                return {};
+            }
+            return column_map.at({ chunk_pos.x, chunk_pos.y })->get_block(block_pos);
+        };
+        const std::vector<nnm::Vector3i> random_positions = random_block_positions(columns, 1 << 20);
+        const std::vector<nnm::Vector3i> coherent_positions = coherent_block_positions(inner_chunks);
+        for (const auto& [name, positions] : { std::pair { "block_at_random", &random_positions },
+                                               std::pair { "block_at_coherent", &coherent_positions } }) {
+            uint64_t block_sum = 0;
+            BenchResult chunk_map = run_bench(name, 0, repeat, [&] {
+                block_sum = 0;
+                for (const nnm::Vector3i pos : *positions) {
+                    block_sum += world_data->block_at(pos).value_or(0);
+                }
+            });
+            chunk_map.query_count = positions->size();
+            uint64_t unordered_map_block_sum = 0;
+            BenchResult unordered_map = run_bench(std::string(name) + "_unordered_map", 0, repeat, [&] {
+                unordered_map_block_sum = 0;
+                for (const nnm::Vector3i pos : *positions) {
+                    unordered_map_block_sum += unordered_map_block_at(pos).value_or(0);
+                }
+            });
+            unordered_map.query_count = positions->size();
+            block_query_mismatch = block_query_mismatch || block_sum != unordered_map_block_sum;
+            results.push_back(std::move(chunk_map));
+            results.push_back(std::move(unordered_map));
+        }
+    }
+
+    // Greedy merging depends on the light, so the chunks are meshed with the light they have in the game
+    relight_columns(*world_data, columns);
+    ChunkMeshPool pool;
+    size_t vertex_count = 0;
+    auto keep_mesh = [&](std::optional<ChunkBufferData> data) {
+        if (data.has_value()) {
+            vertex_count += static_cast<size_t>(data->vertex_data.vertex_count());
+            pool.release(std::move(*data));
+        }
+    };
+    for (const auto& [name, mode] : { std::pair { "create_chunk_buffer_data_naive", MeshingMode::naive },
+                                      std::pair { "create_chunk_buffer_data_greedy", MeshingMode::greedy } }) {
+        BenchResult meshing = run_bench(name, inner_chunks.size(), repeat, [&] {
+            vertex_count = 0;
+            for (const nnm::Vector3i chunk_pos : inner_chunks) {
+                keep_mesh(create_chunk_buffer_data(chunk_pos, *world_data, pool, mode));
+            }
+        });
+        meshing.vertex_count = vertex_count;
+        results.push_back(std::move(meshing));
+    }
+    // Meshed the way mesh jobs do, from a snapshot taken at the level, without skirts since only the chunks along a
+    // ring border get those
+    for (int level = 1; level <= sc_max_lod_level; ++level) {
+        const ChunkLod lod { .level = level };
+        BenchResult meshing = run_bench(
+            "create_chunk_buffer_data_lod_" + std::to_string(level), inner_chunks.size(), repeat, [&] {
+                vertex_count = 0;
+                for (const nnm::Vector3i chunk_pos : inner_chunks) {
+                    // Empty chunks are never submitted for meshing
+                    if (world_data->chunk_data_at(chunk_pos).block_count() == 0) {
+                        continue;
+                    }
+                    ChunkNeighborhood neighborhood(*world_data, chunk_pos, level);
+                    apply_chunk_lod(neighborhood, lod);
+                    keep_mesh(create_chunk_buffer_data(neighborhood, pool, lod_meshing_mode(lod, MeshingMode::greedy)));
+                }
+            });
+        meshing.vertex_count = vertex_count;
+        results.push_back(std::move(meshing));
+    }
+
+    {
+        // The cache is kept smaller than the meshes of one run, so with LRU eviction every lookup is a miss that
+        // evicts an entry and refills its storage, the steady state once the cache is full
+        std::vector<std::unique_ptr<ChunkNeighborhood>> neighborhoods;
+        std::unordered_set<uint64_t> contents;
+        size_t mesh_bytes = 0;
+        for (const nnm::Vector3i chunk_pos : inner_chunks) {
+            if (world_data->chunk_data_at(chunk_pos).block_count() == 0) {
+                continue;
+            }
+            // Chunks without faces or with the same content as another are left out, they would share entries
+            auto neighborhood = std::make_unique<ChunkNeighborhood>(*world_data, chunk_pos);
+            if (!contents.insert(neighborhood->content_hash(static_cast<uint64_t>(MeshingMode::greedy))).second) {
+                continue;
+            }
+            std::optional<ChunkBufferData> data = create_chunk_buffer_data(*neighborhood, pool, MeshingMode::greedy);
+            if (data.has_value()) {
+                mesh_bytes += data->vertex_data.bytes().size() + data->index_data.size() * sizeof(uint32_t);
+                pool.release(std::move(*data));
+                neighborhoods.push_back(std::move(neighborhood));
+            }
+        }
+        ChunkMeshCache cache(mesh_bytes / 4);
+        auto mesh_all = [&] {
+            vertex_count = 0;
+            for (const std::unique_ptr<ChunkNeighborhood>& neighborhood : neighborhoods) {
+                keep_mesh(cache.get_or_create(*neighborhood, pool, MeshingMode::greedy));
+            }
+        };
+        mesh_all();
+        BenchResult cache_miss = run_bench("chunk_mesh_cache_miss", neighborhoods.size(), repeat, mesh_all);
+        cache_miss.vertex_count = vertex_count;
+        if (cache.stats().hits != 0) {
+            std::cerr << "[Bench] Mesh cache lookups hit, the cache is too large to measure misses\n";
+        }
+        results.push_back(std::move(cache_miss));
+    }
+
+    const json meshing_vs_naive = compare_meshing_to_naive(results);
+
+    {
+        // Every visible face of the inner chunks, the ones naive meshing lights
+        struct Face {
+            const ChunkNeighborhood* neighborhood;
+            nnm::Vector3i local_pos;
+            Direction dir;
+        };
+        std::vector<std::unique_ptr<ChunkNeighborhood>> neighborhoods;
+        std::vector<Face> faces;
+        for (const nnm::Vector3i chunk_pos : inner_chunks) {
+            if (world_data->chunk_data_at(chunk_pos).block_count() == 0) {
+                continue;
+            }
+            const ChunkNeighborhood& neighborhood
+                = *neighborhoods.emplace_back(std::make_unique<ChunkNeighborhood>(*world_data, chunk_pos));
+            for_3d({ 0, 0, 0 }, { 16, 16, 16 }, [&](const nnm::Vector3i local_pos) {
+                if (neighborhood.block(local_pos) == 0) {
+                    return;
+                }
+                for (int f = 0; f < 6; ++f) {
+                    const auto dir = static_cast<Direction>(f);
+                    if (const uint8_t adj_block = neighborhood.block(local_pos + direction_vector(dir));
+                        adj_block == ChunkNeighborhood::sc_missing_block || is_transparent(adj_block)) {
+                        faces.push_back({ &neighborhood, local_pos, dir });
+                    }
+                }
+            });
+        }
+        uint64_t lighting_sum = 0;
+        BenchResult face_lighting = run_bench("calc_chunk_face_lighting", 0, repeat, [&] {
+            for (const auto& [neighborhood, local_pos, dir] : faces) {
+                const std::array<uint8_t, 4> lighting = calc_chunk_face_lighting(*neighborhood, local_pos, dir);
+                lighting_sum += lighting[0] + lighting[1] + lighting[2] + lighting[3];
+            }
+        });
+        face_lighting.face_count = faces.size();
+        // Keeps the lighting from being optimized away
+        if (lighting_sum == 0) {
+            std::cerr << "[Bench] Every face was unlit\n";
+        }
+        results.push_back(std::move(face_lighting));
+    }
+
+    {
+        SaveFile save_file(16 * 1024 * 1024, "bench");
+        results.push_back(run_bench("save_file_write", columns.size() * 20, repeat, [&] {
+            save_file.begin_batch();
+            for (const nnm::Vector2i col : columns) {
+                save_file.insert<nnm::Vector2i, ChunkColumn>(col, world_data->chunk_column_data_at(col));
+            }
+            save_file.submit_batch();
+        }));
+        const auto column = std::make_unique<ChunkColumn>();
+        results.push_back(run_bench("save_file_read", columns.size() * 20, repeat, [&] {
+            for (const nnm::Vector2i col : columns) {
+                save_file.read_into(col, *column);
+            }
+        }));
+    }
+
+    results.push_back(run_bench("relight_columns", columns.size() * 20, repeat, [&] {
+        relight_columns(*world_data, columns);
+    }));
+    // Every thread count has to light the world exactly like the serial relight
+    const std::vector<uint8_t> serial_light = light_of(*world_data, chunks_of(columns));
+    size_t parallel_light_mismatch_count = 0;
+    json light_scaling = json::array();
+    for (const size_t thread_count : thread_counts_up_to(max_threads)) {
+        BS::thread_pool thread_pool(static_cast<BS::concurrency_t>(thread_count));
+        LightScheduler scheduler(thread_pool);
+        BenchResult scheduled = run_bench(
+            "light_scheduler_" + std::to_string(thread_count) + "_threads", columns.size() * 20, repeat, [&] {
+                scheduler.relight_columns(*world_data, columns);
+            });
+        scheduled.thread_count = thread_count;
+        parallel_light_mismatch_count += count_differences(light_of(*world_data, chunks_of(columns)), serial_light);
+        const auto time_ns = static_cast<double>(scheduled.sample.time.count());
+        const auto single_thread_time_ns = light_scaling.empty() ? time_ns : light_scaling[0]["time_ns"].get<double>();
+        light_scaling.push_back({ { "threads", thread_count },
+                                  { "time_ns", time_ns },
+                                  { "speedup", time_ns > 0.0 ? single_thread_time_ns / time_ns : 0.0 } });
+        results.push_back(std::move(scheduled));
+    }
+
+    // Incremental lighting expects settled light, which generation alone does not produce
+    relight_columns(*world_data, columns);
+    // Lit like in the game, light spreading into caves and under trees makes chunks keep a light array
+    const json memory = column_memory(*world_data, columns);
+    const std::vector<BlockEdit> edits = random_edits(generator, columns_within(radius - 2), sc_light_edit_count);
+    LightEngine light_engine;
+    auto update_light = [&](const nnm::Vector3i pos, const uint8_t old_block) {
+        light_engine.update_block(*world_data, pos, old_block);
+    };
+    // Checked against relighting from scratch both after the edits and after undoing them
+    std::vector<BlockEdit> undo = apply_edits(*world_data, edits, update_light);
+    size_t light_mismatch_count = count_light_mismatches(*world_data, columns);
+    apply_edits(*world_data, undo, update_light);
+    light_mismatch_count += count_light_mismatches(*world_data, columns);
+
+    BenchResult light_edit { .name = "light_engine_update_block", .edit_count = edits.size() };
+    for (int i = 0; i < repeat; ++i) {
+        keep_fastest(light_edit, measure([&] { undo = apply_edits(*world_data, edits, update_light); }));
+        apply_edits(*world_data, undo, update_light);
+    }
+    results.push_back(std::move(light_edit));
+
+    // What an edit cost before LightEngine, leaves the light unsettled so it runs last
+    BenchResult refresh_edit { .name = "refresh_lighting_edit", .edit_count = edits.size() };
+    auto refresh_light = [&](const nnm::Vector3i pos, uint8_t) {
+        refresh_lighting(*world_data, chunk_pos_from_block_pos(pos));
+    };
+    for (int i = 0; i < repeat; ++i) {
+        keep_fastest(refresh_edit, measure([&] { undo = apply_edits(*world_data, edits, refresh_light); }));
+        apply_edits(*world_data, undo, refresh_light);
+    }
+    results.push_back(std::move(refresh_edit));
+    world_data.reset();
+
+    json output { { "seed", sc_seed },
+                  { "radius", radius },
+                  { "repeat", repeat },
+                  { "light_edit_mismatches", light_mismatch_count },
+                  { "parallel_light_mismatches", parallel_light_mismatch_count },
+                  { "light_scaling", light_scaling },
+                  { "memory", memory },
+                  { "meshing_vs_naive", meshing_vs_naive },
+                  { "benchmarks", json::array() } };
+#ifdef NDEBUG
+    output["build"] = "optimized";
+#else
+    output["build"] = "debug";
+#endif
+    for (const BenchResult& result : results) {
+        output["benchmarks"].push_back(to_json(result));
+    }
+
+    std::filesystem::current_path(work_dir.parent_path());
+    std::filesystem::remove_all(work_dir);
+
+    if (out_path.empty()) {
+        std::cout << output.dump(4) << "\n";
+    }
+    else {
+        std::ofstream(out_path) << output.dump(4) << "\n";
+    }
+    if (block_query_mismatch) {
+        std::cerr << "[Bench] block_at found other blocks than the std::unordered_map lookup\n";
+        return EXIT_FAILURE;
+    }
+    if (light_mismatch_count > 0) {
+        std::cerr << "[Bench] LightEngine lit " << light_mismatch_count << " voxels differently than a full relight\n";
+        return EXIT_FAILURE;
+    }
+    if (parallel_light_mismatch_count > 0) {
+        std::cerr << "[Bench] LightScheduler lit " << parallel_light_mismatch_count
+                  << " voxels differently than a serial relight\n";
+        return EXIT_FAILURE;
+    }
+    if (!baseline_path.empty()) {
+        std::ifstream baseline_file(baseline_path);
+        const json baseline = json::parse(baseline_file, nullptr, false);
+        if (baseline.is_discarded()) {
+            std::cerr << "[Bench] Invalid baseline JSON\n";
+            return EXIT_FAILURE;
+        }
+        return compare_to_baseline(output, baseline) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
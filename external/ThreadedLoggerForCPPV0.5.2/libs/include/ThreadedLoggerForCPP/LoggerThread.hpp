@@ -240,7 +240,7 @@ private:
 #ifdef _WIN32
     localtime_s(&timeinfo, &in_time_t);
 #else
-    localtime_r(&timeinfo, &in_time_t);
+    localtime_r(&in_time_t, &timeinfo);
 #endif
 
     char buffer[80];
@@ -49,6 +49,9 @@ public:
 
     void draw_index_buffer(const IndexBuffer& index_buffer);
 
+    // Draws index_count indices starting at first_index, lets one buffer hold several ranges drawn separately
+    void draw_index_buffer(const IndexBuffer& index_buffer, uint32_t first_index, uint32_t index_count);
+
     void end_frame(const Window& window);
 
     void end_render_pass() const;
@@ -1,9 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include <nnm/nnm.hpp>
 
+#include <mve/common.hpp>
+
 namespace mve {
 
 enum class VertexAttributeType {
@@ -11,12 +21,54 @@ enum class VertexAttributeType {
     vec2,
     vec3,
     vec4,
+    uint,
 };
 
 using VertexLayout = std::vector<VertexAttributeType>;
 
 [[nodiscard]] int get_vertex_layout_bytes(const VertexLayout& vertex_layout);
 
+[[nodiscard]] constexpr int get_vertex_attribute_bytes(const VertexAttributeType type)
+{
+    switch (type) {
+    case VertexAttributeType::scalar:
+        return sizeof(float);
+    case VertexAttributeType::vec2:
+        return sizeof(nnm::Vector2f);
+    case VertexAttributeType::vec3:
+        return sizeof(nnm::Vector3f);
+    case VertexAttributeType::vec4:
+        return sizeof(nnm::Vector4f);
+    case VertexAttributeType::uint:
+        return sizeof(uint32_t);
+    }
+    return 0;
+}
+
+// A whole vertex as a struct that can be appended to VertexData in bulk. It lists the types of its members in order in
+// a static constexpr std::array named attributes and its members must be laid out back to back like the attributes.
+template <typename T>
+concept Vertex = std::is_trivially_copyable_v<T> && requires {
+    { T::attributes.size() } -> std::convertible_to<size_t>;
+    { T::attributes[0] } -> std::convertible_to<VertexAttributeType>;
+};
+
+template <Vertex T>
+[[nodiscard]] constexpr int get_vertex_bytes()
+{
+    int byte_count = 0;
+    for (const VertexAttributeType type : T::attributes) {
+        byte_count += get_vertex_attribute_bytes(type);
+    }
+    return byte_count;
+}
+
+template <Vertex T>
+[[nodiscard]] VertexLayout vertex_layout()
+{
+    return { T::attributes.begin(), T::attributes.end() };
+}
+
 class VertexData {
 public:
     explicit VertexData(VertexLayout layout);
@@ -29,9 +81,35 @@ public:
 
     void push_back(nnm::Vector4f value);
 
+    void push_back(uint32_t value);
+
+    // Appends whole vertices with a single copy, see Vertex
+    template <Vertex T>
+    void append_vertices(std::span<const T> vertices)
+    {
+        static_assert(get_vertex_bytes<T>() == sizeof(T), "[VertexData] Vertex is padded or does not match attributes");
+        MVE_VAL_ASSERT(is_complete(), "[VertexData] Appending vertices to an incomplete vertex")
+        MVE_VAL_ASSERT(std::ranges::equal(m_layout, T::attributes), "[VertexData] Vertex does not match the layout")
+
+        append(vertices.data(), vertices.size_bytes());
+
+        m_data_count += static_cast<int>(vertices.size() * m_layout.size());
+    }
+
+    // Reserves space for vertex_count vertices in total
+    void reserve(int vertex_count);
+
+    // Takes ownership of data as the vertex data without copying, data must hold whole vertices in this layout
+    void adopt(std::vector<std::byte> data);
+
+    // Gives up the vertex data without copying and leaves this empty with the same layout
+    [[nodiscard]] std::vector<std::byte> release() noexcept;
+
     [[nodiscard]] VertexAttributeType next_type() const noexcept;
 
-    [[nodiscard]] const float* data_ptr() const noexcept;
+    [[nodiscard]] const std::byte* data_ptr() const noexcept;
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept;
 
     [[nodiscard]] int data_count() const noexcept;
 
@@ -39,11 +117,18 @@ public:
 
     [[nodiscard]] bool is_complete() const noexcept;
 
-    [[nodiscard]] VertexLayout layout() const noexcept;
+    [[nodiscard]] const VertexLayout& layout() const noexcept;
 
 private:
+    void append(const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
     VertexLayout m_layout;
-    std::vector<float> m_data;
+    // Raw bytes since attributes can be of different scalar types
+    std::vector<std::byte> m_data;
     int m_data_count = 0;
 };
 }
@@ -1142,6 +1142,17 @@ void Renderer::draw_index_buffer(const IndexBuffer& index_buffer)
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
+void Renderer::draw_index_buffer(
+    const IndexBuffer& index_buffer, const uint32_t first_index, const uint32_t index_count)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    auto& [buffer, buffer_index_count] = *m_index_buffers[index_buffer.handle()];
+    MVE_VAL_ASSERT(first_index + index_count <= buffer_index_count, "[Renderer] Index range out of bounds")
+    m_current_draw_state.command_buffer.bindIndexBuffer(buffer.vk_handle, 0, vk::IndexType::eUint32, m_vk_loader);
+    m_current_draw_state.command_buffer.drawIndexed(index_count, 1, first_index, 0, 0, m_vk_loader);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
 GraphicsPipeline Renderer::create_graphics_pipeline(
     const Shader& vertex_shader,
     const Shader& fragment_shader,
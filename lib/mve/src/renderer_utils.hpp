@@ -1007,6 +1007,10 @@ inline std::vector<vk::VertexInputAttributeDescription> create_vk_attribute_desc
             description.setFormat(vk::Format::eR32G32B32A32Sfloat);
             offset += sizeof(nnm::Vector4f);
             break;
+        case VertexAttributeType::uint:
+            description.setFormat(vk::Format::eR32Uint);
+            offset += sizeof(uint32_t);
+            break;
         }
 
         attribute_descriptions.push_back(description);
@@ -1,6 +1,7 @@
 #include <mve/vertex_data.hpp>
 
 #include <stdexcept>
+#include <utility>
 
 #include <mve/common.hpp>
 
@@ -13,20 +14,7 @@ int get_vertex_layout_bytes(const VertexLayout& vertex_layout)
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     int byte_count = 0;
     for (const VertexAttributeType type : vertex_layout) {
-        switch (type) {
-        case VertexAttributeType::scalar:
-            byte_count += sizeof(float);
-            break;
-        case VertexAttributeType::vec2:
-            byte_count += sizeof(nnm::Vector2f);
-            break;
-        case VertexAttributeType::vec3:
-            byte_count += sizeof(nnm::Vector3f);
-            break;
-        case VertexAttributeType::vec4:
-            byte_count += sizeof(nnm::Vector4f);
-            break;
-        }
+        byte_count += get_vertex_attribute_bytes(type);
     }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     return byte_count;
@@ -43,7 +31,7 @@ void VertexData::push_back(const float value)
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     MVE_VAL_ASSERT(next_type() == VertexAttributeType::scalar, "[VertexData] Invalid type: scalar")
 
-    m_data.push_back(value);
+    append(&value, sizeof(float));
 
     m_data_count++;
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
@@ -54,8 +42,7 @@ void VertexData::push_back(nnm::Vector2f value)
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     MVE_VAL_ASSERT(next_type() == VertexAttributeType::vec2, "[VertexData] Invalid type: vec2")
 
-    m_data.push_back(value[0]);
-    m_data.push_back(value[1]);
+    append(&value[0], sizeof(nnm::Vector2f));
 
     m_data_count++;
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
@@ -66,9 +53,7 @@ void VertexData::push_back(nnm::Vector3f value)
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     MVE_VAL_ASSERT(next_type() == VertexAttributeType::vec3, "[VertexData] Invalid type: vec3")
 
-    m_data.push_back(value[0]);
-    m_data.push_back(value[1]);
-    m_data.push_back(value[2]);
+    append(&value[0], sizeof(nnm::Vector3f));
 
     m_data_count++;
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
@@ -79,25 +64,58 @@ void VertexData::push_back(nnm::Vector4f value)
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     MVE_VAL_ASSERT(next_type() == VertexAttributeType::vec4, "[VertexData] Invalid type: vec4")
 
-    m_data.push_back(value[0]);
-    m_data.push_back(value[1]);
-    m_data.push_back(value[2]);
-    m_data.push_back(value[3]);
+    append(&value[0], sizeof(nnm::Vector4f));
 
     m_data_count++;
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
+void VertexData::push_back(const uint32_t value)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    MVE_VAL_ASSERT(next_type() == VertexAttributeType::uint, "[VertexData] Invalid type: uint")
+
+    append(&value, sizeof(uint32_t));
+
+    m_data_count++;
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void VertexData::adopt(std::vector<std::byte> data)
+{
+    const auto vertex_bytes = static_cast<size_t>(get_vertex_layout_bytes(m_layout));
+    MVE_VAL_ASSERT(data.size() % vertex_bytes == 0, "[VertexData] Adopted data is not a whole number of vertices")
+
+    m_data_count = static_cast<int>(data.size() / vertex_bytes * m_layout.size());
+    m_data = std::move(data);
+}
+
+std::vector<std::byte> VertexData::release() noexcept
+{
+    m_data_count = 0;
+    return std::exchange(m_data, {});
+}
+
+void VertexData::reserve(const int vertex_count)
+{
+    m_data.reserve(static_cast<size_t>(vertex_count) * get_vertex_layout_bytes(m_layout));
+}
+
 VertexAttributeType VertexData::next_type() const noexcept
 {
     return m_layout[m_data_count % m_layout.size()];
 }
 
-const float* VertexData::data_ptr() const noexcept
+const std::byte* VertexData::data_ptr() const noexcept
 {
     return m_data.data();
 }
 
+std::span<const std::byte> VertexData::bytes() const noexcept
+{
+    return m_data;
+}
+
 int VertexData::data_count() const noexcept
 {
     return m_data_count;
@@ -108,7 +126,7 @@ bool VertexData::is_complete() const noexcept
     return m_data_count % m_layout.size() == 0;
 }
 
-VertexLayout VertexData::layout() const noexcept
+const VertexLayout& VertexData::layout() const noexcept
 {
     return m_layout;
 }
@@ -1,4 +1,5 @@
 #include "app.hpp"
+#include <algorithm>
 
 #include <fstream>
 
@@ -60,6 +61,7 @@ App::App()
     }))
     , m_fixed_loop(60.0f)
     , m_begin_time(std::chrono::high_resolution_clock::now())
+    , m_frame_begin_time(m_begin_time)
 {
     InitThreadedLoggerForCPP(_exe_game, _exe_game, _exe_game);
     m_window.set_min_size({ 800, 600 });
@@ -77,14 +79,15 @@ App::App()
 
     std::invoke(resize_func, m_window.size());
 
-    auto [fullscreen, msaa] = load_options();
-    if (fullscreen) {
+    const Options options = load_options();
+    if (options.fullscreen) {
         m_window.fullscreen(true);
     }
     else {
         m_window.windowed();
     }
-    m_renderer.set_msaa_samples(m_window, msaa);
+    m_renderer.set_msaa_samples(m_window, options.msaa);
+    m_world.set_mesh_cache_max_memory(options.mesh_cache_max_memory);
 
     ENetAddress address;
     enet_address_set_host_ip(&address, "127.0.0.1");
@@ -152,20 +155,44 @@ void App::main_loop()
         }
 
         m_world.update_debug_fps(m_frame_count);
+        m_world.update_debug_frame_time_p99(m_frame_time_p99);
 
         draw();
 
-        if (std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration_cast<std::chrono::microseconds>(end_time - m_begin_time).count() >= 1000000) {
+        const std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+        const float frame_time = std::chrono::duration<float, std::milli>(end_time - m_frame_begin_time).count();
+        m_frame_times.push_back(frame_time);
+        m_frame_begin_time = end_time;
+        if (m_world.is_on_flight_path()) {
+            m_flight_path_frame_times.push_back(frame_time);
+        }
+        else if (!m_flight_path_frame_times.empty()) {
+            const auto p99 = m_flight_path_frame_times.begin()
+                + static_cast<ptrdiff_t>(m_flight_path_frame_times.size() * 99 / 100);
+            std::ranges::nth_element(m_flight_path_frame_times, p99);
+            LOGGER_THREAD(
+                LogLevel::INFO,
+                "[App] Flight path frame time p99: " + std::to_string(*p99) + " ms over "
+                    + std::to_string(m_flight_path_frame_times.size()) + " frames")
+            m_flight_path_frame_times.clear();
+        }
+        if (std::chrono::duration_cast<std::chrono::microseconds>(end_time - m_begin_time).count() >= 1000000) {
             m_begin_time = std::chrono::high_resolution_clock::now();
             m_frame_count = m_current_frame_count;
             m_current_frame_count = 0;
+            // Frame time spikes such as a main thread stall on meshing show up here long before they move the average
+            const auto p99 = m_frame_times.begin() + static_cast<ptrdiff_t>(m_frame_times.size() * 99 / 100);
+            std::ranges::nth_element(m_frame_times, p99);
+            m_frame_time_p99 = *p99;
+            m_frame_times.clear();
         }
         m_current_frame_count++;
     }
     gamePerformanceProfiler.print();
     LoggerThread::GetLoggerThread().ExitLoggerThread();
-    const Options options { .fullscreen = m_window.is_fullscreen(), .msaa = m_renderer.current_msaa_samples() };
+    const Options options { .fullscreen = m_window.is_fullscreen(),
+                            .msaa = m_renderer.current_msaa_samples(),
+                            .mesh_cache_max_memory = m_world.mesh_cache_max_memory() };
     set_options(options);
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
@@ -36,8 +36,14 @@ private:
     mve::Framebuffer m_world_framebuffer;
     util::FixedLoop m_fixed_loop;
     std::chrono::high_resolution_clock::time_point m_begin_time;
+    std::chrono::high_resolution_clock::time_point m_frame_begin_time;
     int m_frame_count = 0;
     int m_current_frame_count = 0;
+    // Durations in milliseconds of the frames in the current second
+    std::vector<float> m_frame_times {};
+    float m_frame_time_p99 = 0.0f;
+    // Durations in milliseconds of every frame while the player is on the flight path, logged once it ends
+    std::vector<float> m_flight_path_frame_times {};
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+struct BlockProperties {
+    // Faces of neighbouring blocks against it are drawn and its own faces go in the translucent pass
+    bool transparent = false;
+    // Block light given off, the block itself is lit this much even when it stops light from passing through
+    uint8_t light_emission = 0;
+    // Light lost entering the block on top of the 1 lost per step, light never enters a block with an opacity of 15
+    uint8_t light_opacity = 15;
+};
+
+// Properties of every block type indexed by type, types without an entry are solid blocks that give off no light
+inline constexpr std::array<BlockProperties, 256> sc_block_properties = [] {
+    std::array<BlockProperties, 256> properties {};
+    // Air
+    properties[0] = { .transparent = true, .light_emission = 0, .light_opacity = 0 };
+    // Leaves
+    properties[9] = { .transparent = true, .light_emission = 0, .light_opacity = 0 };
+    // Lamp
+    properties[10] = { .transparent = false, .light_emission = 15, .light_opacity = 15 };
+    return properties;
+}();
+
+[[nodiscard]] constexpr uint8_t light_emission(const uint8_t block_type)
+{
+    return sc_block_properties[block_type].light_emission;
+}
+
+[[nodiscard]] constexpr uint8_t light_opacity(const uint8_t block_type)
+{
+    return sc_block_properties[block_type].light_opacity;
+}
+
+// Light passes into the block at all
+[[nodiscard]] constexpr bool lets_light_through(const uint8_t block_type)
+{
+    return light_opacity(block_type) < 15;
+}
@@ -0,0 +1,197 @@
+#include "block_storage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <optional>
+
+#include <cereal/details/helpers.hpp>
+
+// Templated on the width so the shifts are constant and the loop vectorizes
+template <int bits>
+static uint64_t max_palette_index(const std::vector<uint64_t>& words)
+{
+    uint64_t max = 0;
+    for (const uint64_t word : words) {
+        for (int shift = 0; shift < 64; shift += bits) {
+            max = std::max(max, (word >> shift) & ((uint64_t { 1 } << bits) - 1));
+        }
+    }
+    return max;
+}
+
+uint8_t BlockStorage::set(const size_t index, const uint8_t type)
+{
+    VV_DEB_ASSERT(index < sc_volume, "[BlockStorage] Invalid index")
+    const size_t old_palette_index = m_bits == 0 ? 0 : palette_index(index);
+    const uint8_t old_type = m_palette[old_palette_index];
+    if (old_type == type) {
+        return old_type;
+    }
+
+    std::optional<size_t> new_palette_index;
+    std::optional<size_t> free_palette_index;
+    for (size_t i = 0; i < m_palette.size(); ++i) {
+        if (m_palette[i] == type) {
+            new_palette_index = i;
+            break;
+        }
+        if (m_counts[i] == 0 && !free_palette_index.has_value()) {
+            free_palette_index = i;
+        }
+    }
+    if (!new_palette_index.has_value() && free_palette_index.has_value()) {
+        new_palette_index = free_palette_index;
+        m_palette[*new_palette_index] = type;
+    }
+    if (!new_palette_index.has_value()) {
+        if (const int bits = bits_for_palette_size(m_palette.size() + 1); bits > m_bits) {
+            repack(bits);
+        }
+        new_palette_index = m_palette.size();
+        m_palette.push_back(type);
+        m_counts.push_back(0);
+    }
+
+    // The old entry may have moved if the indices were re-packed
+    const size_t current_old_index = m_bits == 0 ? 0 : palette_index(index);
+    set_palette_index(index, *new_palette_index);
+    m_counts[*new_palette_index]++;
+    if (--m_counts[current_old_index] == 0) {
+        const size_t live_count = live_palette_size();
+        if (live_count == 1) {
+            // Collapsing to a single type needs no re-pack, the index array is just dropped
+            fill(type);
+        }
+        // Shrinking only once the palette would fit twice over in the narrower width keeps a block being placed and
+        // removed at a width boundary from re-packing the whole chunk every time
+        else if (const int bits = bits_for_palette_size(live_count * 2); bits < m_bits) {
+            repack(bits);
+        }
+    }
+    return old_type;
+}
+
+BlockStorage BlockStorage::compacted() const
+{
+    BlockStorage storage = *this;
+    if (!is_compact()) {
+        storage.repack(bits_for_palette_size(live_palette_size()));
+    }
+    return storage;
+}
+
+void BlockStorage::fill(const uint8_t type)
+{
+    m_palette = { type };
+    m_counts = { sc_volume };
+    // Swapped rather than cleared, clearing keeps the capacity
+    std::vector<uint64_t>().swap(m_words);
+    m_bits = 0;
+}
+
+int BlockStorage::count(const uint8_t type) const
+{
+    for (size_t i = 0; i < m_palette.size(); ++i) {
+        if (m_palette[i] == type) {
+            return m_counts[i];
+        }
+    }
+    return 0;
+}
+
+size_t BlockStorage::live_palette_size() const
+{
+    return static_cast<size_t>(std::ranges::count_if(m_counts, [](const uint16_t c) {
+        return c != 0;
+    }));
+}
+
+void BlockStorage::validate() const
+{
+    if (m_bits != 0 && m_bits != 1 && m_bits != 2 && m_bits != 4 && m_bits != 8) {
+        throw cereal::Exception("[BlockStorage] Invalid bits per block");
+    }
+    if (m_words.size() != static_cast<size_t>(sc_volume * m_bits / 64)) {
+        throw cereal::Exception("[BlockStorage] Index array does not match bits per block");
+    }
+    if (m_palette.empty() || m_counts.size() != m_palette.size() || m_palette.size() > size_t { 1 } << m_bits) {
+        throw cereal::Exception("[BlockStorage] Invalid palette size");
+    }
+    // Indices past the end of the palette would make get and set read and write out of bounds. A full palette can't
+    // be indexed past, which skips the scan for most chunks with 8 bits
+    if (m_bits != 0 && m_palette.size() < size_t { 1 } << m_bits) {
+        uint64_t max = 0;
+        switch (m_bits) {
+        case 1:
+            max = max_palette_index<1>(m_words);
+            break;
+        case 2:
+            max = max_palette_index<2>(m_words);
+            break;
+        case 4:
+            max = max_palette_index<4>(m_words);
+            break;
+        default:
+            max = max_palette_index<8>(m_words);
+            break;
+        }
+        if (max >= m_palette.size()) {
+            throw cereal::Exception("[BlockStorage] Palette index out of range");
+        }
+    }
+    if (std::accumulate(m_counts.begin(), m_counts.end(), 0) != sc_volume) {
+        throw cereal::Exception("[BlockStorage] Palette counts do not add up to the chunk volume");
+    }
+}
+
+bool BlockStorage::is_compact() const
+{
+    const size_t live_count = live_palette_size();
+    return live_count == m_palette.size() && bits_for_palette_size(live_count) == m_bits;
+}
+
+void BlockStorage::repack(const int bits)
+{
+    std::array<uint8_t, 256> remap {};
+    std::vector<uint8_t> palette;
+    std::vector<uint16_t> counts;
+    for (size_t i = 0; i < m_palette.size(); ++i) {
+        if (m_counts[i] != 0) {
+            remap[i] = static_cast<uint8_t>(palette.size());
+            palette.push_back(m_palette[i]);
+            counts.push_back(m_counts[i]);
+        }
+    }
+    VV_DEB_ASSERT(bits_for_palette_size(palette.size()) <= bits, "[BlockStorage] Bit width too small for palette")
+
+    std::vector<uint64_t> words(static_cast<size_t>(sc_volume * bits / 64), 0);
+    if (bits != 0) {
+        for (size_t i = 0; i < sc_volume; ++i) {
+            const uint64_t new_index = remap[m_bits == 0 ? 0 : palette_index(i)];
+            const size_t bit = i * bits;
+            words[bit >> 6] |= new_index << (bit & 63);
+        }
+    }
+    m_palette = std::move(palette);
+    m_counts = std::move(counts);
+    m_words = std::move(words);
+    m_bits = static_cast<uint8_t>(bits);
+}
+
+int BlockStorage::bits_for_palette_size(const size_t size)
+{
+    if (size <= 1) {
+        return 0;
+    }
+    if (size <= 2) {
+        return 1;
+    }
+    if (size <= 4) {
+        return 2;
+    }
+    if (size <= 16) {
+        return 4;
+    }
+    return 8;
+}
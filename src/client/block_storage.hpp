@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// ReSharper disable once CppUnusedIncludeDirective
+#include <cereal/types/vector.hpp>
+
+#include "../common/assert.hpp"
+
+// Palette-compressed storage of the 16^3 block types of a chunk. Each chunk keeps a small palette of the block types
+// it contains and a bit-packed array of palette indices using 0, 1, 2, 4 or 8 bits per block. With 0 bits the chunk
+// is uniform and no index array is allocated at all.
+class BlockStorage {
+public:
+    static constexpr int sc_volume = 16 * 16 * 16;
+
+    [[nodiscard]] uint8_t get(const size_t index) const
+    {
+        VV_DEB_ASSERT(index < sc_volume, "[BlockStorage] Invalid index")
+        if (m_bits == 0) {
+            return m_palette[0];
+        }
+        return m_palette[palette_index(index)];
+    }
+
+    // Returns the previous block type at index
+    uint8_t set(size_t index, uint8_t type);
+
+    void fill(uint8_t type);
+
+    [[nodiscard]] bool is_uniform() const
+    {
+        return m_bits == 0;
+    }
+
+    [[nodiscard]] int bits_per_block() const
+    {
+        return m_bits;
+    }
+
+    [[nodiscard]] size_t palette_size() const
+    {
+        return m_palette.size();
+    }
+
+    // Amount of times block type appears in the chunk
+    [[nodiscard]] int count(uint8_t type) const;
+
+    // Whether any block type in the chunk satisfies predicate, only the palette is checked
+    template <typename Predicate>
+    [[nodiscard]] bool contains_if(Predicate predicate) const
+    {
+        for (size_t i = 0; i < m_palette.size(); ++i) {
+            if (m_counts[i] > 0 && predicate(m_palette[i])) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] size_t memory_usage() const
+    {
+        return m_palette.capacity() * sizeof(uint8_t) + m_counts.capacity() * sizeof(uint16_t)
+            + m_words.capacity() * sizeof(uint64_t);
+    }
+
+    // Copy re-packed to the narrowest width for its palette, with unused palette entries removed
+    [[nodiscard]] BlockStorage compacted() const;
+
+    // Palette entries are shrunk lazily while editing, saves are always written compacted
+    template <class Archive>
+    void save(Archive& archive) const
+    {
+        if (is_compact()) {
+            archive(m_palette, m_counts, m_words, m_bits);
+            return;
+        }
+        const BlockStorage storage = compacted();
+        archive(storage.m_palette, storage.m_counts, storage.m_words, storage.m_bits);
+    }
+
+    // Throws cereal::Exception if the loaded data is not a valid storage
+    template <class Archive>
+    void load(Archive& archive)
+    {
+        archive(m_palette, m_counts, m_words, m_bits);
+        validate();
+    }
+
+private:
+    [[nodiscard]] size_t palette_index(const size_t index) const
+    {
+        // Bit widths are powers of two so an entry never straddles two words
+        const size_t bit = index * m_bits;
+        return (m_words[bit >> 6] >> (bit & 63)) & ((uint64_t { 1 } << m_bits) - 1);
+    }
+
+    void set_palette_index(const size_t index, const uint64_t palette_index)
+    {
+        const size_t bit = index * m_bits;
+        const uint64_t mask = ((uint64_t { 1 } << m_bits) - 1) << (bit & 63);
+        m_words[bit >> 6] = (m_words[bit >> 6] & ~mask) | (palette_index << (bit & 63));
+    }
+
+    [[nodiscard]] size_t live_palette_size() const;
+
+    void validate() const;
+
+    [[nodiscard]] bool is_compact() const;
+
+    // Re-packs the indices using bit width, compacting away palette entries that are no longer used
+    void repack(int bits);
+
+    static int bits_for_palette_size(size_t size);
+
+    std::vector<uint8_t> m_palette { 0 };
+    std::vector<uint16_t> m_counts { sc_volume };
+    std::vector<uint64_t> m_words {};
+    uint8_t m_bits = 0;
+};
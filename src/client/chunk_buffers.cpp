@@ -0,0 +1,22 @@
+#include "chunk_buffers.hpp"
+
+ChunkBuffers::ChunkBuffers(
+    mve::Renderer& renderer,
+    mve::GraphicsPipeline& pipeline,
+    const mve::ShaderDescriptorSet& set,
+    const mve::ShaderDescriptorBinding& uniform_buffer_binding,
+    const ChunkBufferData& buffer_data)
+    : m_chunk_pos(buffer_data.chunk_pos)
+    , m_opaque_index_count(static_cast<uint32_t>(buffer_data.opaque_index_count))
+    , m_translucent_index_count(static_cast<uint32_t>(buffer_data.index_data.size() - buffer_data.opaque_index_count))
+    , m_descriptor_set(pipeline.create_descriptor_set(set))
+    , m_uniform_buffer(renderer.create_uniform_buffer(uniform_buffer_binding))
+    , m_vertex_buffer(renderer.create_vertex_buffer(buffer_data.vertex_data))
+    , m_index_buffer(renderer.create_index_buffer(buffer_data.index_data))
+{
+    m_descriptor_set.write_binding(uniform_buffer_binding, m_uniform_buffer);
+    m_uniform_buffer.update(
+        uniform_buffer_binding.member("model").location(),
+        nnm::Transform3f().translate(nnm::Vector3f(m_chunk_pos) * 16.0f).matrix);
+    m_uniform_buffer.update(uniform_buffer_binding.member("fog_influence").location(), 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "chunk_mesh.hpp"
+
+#include <nnm/nnm.hpp>
+
+#include <mve/renderer.hpp>
+
+// GPU side of a chunk mesh. Kept apart from chunk_mesh.hpp so meshing builds without the renderer.
+class ChunkBuffers {
+public:
+    ChunkBuffers(
+        mve::Renderer& renderer,
+        mve::GraphicsPipeline& pipeline,
+        const mve::ShaderDescriptorSet& set,
+        const mve::ShaderDescriptorBinding& uniform_buffer_binding,
+        const ChunkBufferData& buffer_data);
+
+    [[nodiscard]] nnm::Vector3i chunk_pos() const
+    {
+        return m_chunk_pos;
+    }
+
+    [[nodiscard]] bool has_opaque() const
+    {
+        return m_opaque_index_count > 0;
+    }
+
+    [[nodiscard]] bool has_translucent() const
+    {
+        return m_translucent_index_count > 0;
+    }
+
+    void draw_opaque(mve::Renderer& renderer, const mve::DescriptorSet& global_set) const
+    {
+        renderer.bind_descriptor_sets(global_set, m_descriptor_set);
+        renderer.bind_vertex_buffer(m_vertex_buffer);
+        renderer.draw_index_buffer(m_index_buffer, 0, m_opaque_index_count);
+    }
+
+    void draw_translucent(mve::Renderer& renderer, const mve::DescriptorSet& global_set) const
+    {
+        renderer.bind_descriptor_sets(global_set, m_descriptor_set);
+        renderer.bind_vertex_buffer(m_vertex_buffer);
+        renderer.draw_index_buffer(m_index_buffer, m_opaque_index_count, m_translucent_index_count);
+    }
+
+private:
+    nnm::Vector3i m_chunk_pos;
+    uint32_t m_opaque_index_count;
+    uint32_t m_translucent_index_count;
+    // Vertices are chunk-local so every chunk has its own model matrix
+    mve::DescriptorSet m_descriptor_set;
+    mve::UniformBuffer m_uniform_buffer;
+    mve::VertexBuffer m_vertex_buffer;
+    mve::IndexBuffer m_index_buffer;
+};
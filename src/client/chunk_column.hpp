@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <string>
 
+#include <cereal/details/helpers.hpp>
 // ReSharper disable once CppUnusedIncludeDirective
 #include <cereal/types/array.hpp>
 
@@ -15,6 +19,14 @@ class ChunkColumn {
 public:
     enum GenLevel { none, terrain, trees, generated };
 
+    // Written at the start of every saved column and bumped whenever the saved layout of a column changes. Columns
+    // saved with another version fail to load and are generated again. The high half tags the value so saves from
+    // before versioning, which start with the column position, are never taken for a current one
+    static constexpr uint32_t sc_save_version = 0x56560001;
+
+    // Height of a block column that sunlight reaches the bottom of
+    static constexpr int sc_no_opaque_height = -10 * 16 - 1;
+
     ChunkColumn() = default;
 
     explicit ChunkColumn(const nnm::Vector2i chunk_pos)
@@ -22,6 +34,17 @@ public:
     {
     }
 
+    // Returns the column to the state of a freshly constructed one at chunk_pos so its storage can be reused
+    void reset(const nnm::Vector2i chunk_pos)
+    {
+        m_gen_level = none;
+        m_pos = chunk_pos;
+        for (ChunkData& chunk : m_chunks) {
+            chunk.reset();
+        }
+        m_heightmap.fill(sc_no_opaque_height);
+    }
+
     [[nodiscard]] uint8_t get_block(const nnm::Vector3i block_pos) const
     {
         const nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(block_pos);
@@ -29,11 +52,11 @@ public:
         return m_chunks[chunk_pos.z + 10].get_block(block_world_to_local(block_pos));
     }
 
-    void set_lighting(const nnm::Vector3i block_pos, const uint8_t val)
+    void set_sky_light(const nnm::Vector3i block_pos, const uint8_t val)
     {
         const nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(block_pos);
         VV_DEB_ASSERT(chunk_pos.z >= -10 && chunk_pos.z < 10, "[ChunkColumn] Invalid block position");
-        m_chunks[chunk_pos.z + 10].set_lighting(block_world_to_local(block_pos), val);
+        m_chunks[chunk_pos.z + 10].set_sky_light(block_world_to_local(block_pos), val);
     }
 
     [[nodiscard]] uint8_t lighting_at(const nnm::Vector3i block_pos) const
@@ -47,7 +70,28 @@ public:
     {
         const nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(block_pos);
         VV_DEB_ASSERT(chunk_pos.z >= -10 && chunk_pos.z < 10, "[ChunkColumn] Invalid block position");
-        m_chunks[chunk_pos.z + 10].set_block(block_world_to_local(block_pos), type);
+        const nnm::Vector3i local_pos = block_world_to_local(block_pos);
+        m_chunks[chunk_pos.z + 10].set_block(local_pos, type);
+        int16_t& height = m_heightmap[local_pos.x + local_pos.y * 16];
+        if (light_opacity(type) != 0) {
+            height = std::max(height, static_cast<int16_t>(block_pos.z));
+        }
+        else if (block_pos.z == height) {
+            height = static_cast<int16_t>(find_opaque_height({ local_pos.x, local_pos.y }, block_pos.z - 1));
+        }
+    }
+
+    // Height of the highest block in the block column at local_col that sunlight cannot pass straight through, or
+    // sc_no_opaque_height if there is none. Kept up to date by set_block.
+    [[nodiscard]] int highest_opaque_height(const nnm::Vector2i local_col) const
+    {
+        VV_DEB_ASSERT(is_block_pos_local_col(local_col), "[ChunkColumn] Invalid local block column");
+        return m_heightmap[local_col.x + local_col.y * 16];
+    }
+
+    [[nodiscard]] const std::array<int16_t, 16 * 16>& heightmap() const
+    {
+        return m_heightmap;
     }
 
     [[nodiscard]] const ChunkData& chunk_data_at(const nnm::Vector3i chunk_pos) const
@@ -67,9 +111,25 @@ public:
     }
 
     template <class Archive>
-    void serialize(Archive& archive)
+    void save(Archive& archive) const
     {
-        archive(m_pos, m_chunks, m_gen_level);
+        // The heightmap follows from the blocks but is saved too, rebuilding it took as long as reading the rest
+        archive(sc_save_version, m_pos, m_chunks, m_gen_level, m_heightmap);
+    }
+
+    // Throws cereal::Exception if the column was saved with another version or its data is invalid
+    template <class Archive>
+    void load(Archive& archive)
+    {
+        uint32_t version = 0;
+        archive(version);
+        if (version != sc_save_version) {
+            throw cereal::Exception("[ChunkColumn] Unsupported save version " + std::to_string(version));
+        }
+        archive(m_pos, m_chunks, m_gen_level, m_heightmap);
+        if (m_gen_level < none || m_gen_level > generated) {
+            throw cereal::Exception("[ChunkColumn] Invalid generation level");
+        }
     }
 
     void set_gen_level(const GenLevel level)
@@ -87,8 +147,34 @@ public:
         return m_pos;
     }
 
+    [[nodiscard]] size_t memory_usage() const
+    {
+        size_t total = sizeof(ChunkColumn);
+        for (const ChunkData& chunk : m_chunks) {
+            total += chunk.heap_memory_usage();
+        }
+        return total;
+    }
+
 private:
+    // Highest block at or below from_height in the block column that sunlight cannot pass straight through
+    [[nodiscard]] int find_opaque_height(const nnm::Vector2i local_col, const int from_height) const
+    {
+        for (int z = from_height; z > sc_no_opaque_height; --z) {
+            if (light_opacity(m_chunks[(z >> 4) + 10].get_block({ local_col.x, local_col.y, z & 15 })) != 0) {
+                return z;
+            }
+        }
+        return sc_no_opaque_height;
+    }
+
     GenLevel m_gen_level = none;
     nnm::Vector2i m_pos;
     std::array<ChunkData, 20> m_chunks = {};
+    // Indexed by x + y * 16 of the local block column
+    std::array<int16_t, 16 * 16> m_heightmap = [] {
+        std::array<int16_t, 16 * 16> heightmap {};
+        heightmap.fill(sc_no_opaque_height);
+        return heightmap;
+    }();
 };
\ No newline at end of file
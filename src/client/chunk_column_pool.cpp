@@ -0,0 +1,29 @@
+#include "chunk_column_pool.hpp"
+
+#include <game_performance_profiler.hpp>
+
+ChunkColumn* ChunkColumnPool::acquire(const nnm::Vector2i chunk_pos)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    if (m_free.empty()) {
+        const std::unique_ptr<Slab>& slab = m_slabs.emplace_back(std::make_unique<Slab>());
+        // Pushed in reverse so slots are handed out in address order
+        for (auto it = slab->rbegin(); it != slab->rend(); ++it) {
+            m_free.push_back(&*it);
+        }
+    }
+    ChunkColumn* column = m_free.back();
+    m_free.pop_back();
+    column->reset(chunk_pos);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    return column;
+}
+
+void ChunkColumnPool::release(ChunkColumn* column)
+{
+    VV_DEB_ASSERT(column != nullptr, "[ChunkColumnPool] Released null column")
+    // Frees the per-voxel block and light arrays of every chunk now rather than holding on to them until the slot is
+    // reused, only the few bytes of each chunk's palette are kept
+    column->reset(column->pos());
+    m_free.push_back(column);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <nnm/nnm.hpp>
+
+#include "chunk_column.hpp"
+
+// Slab allocator of chunk columns. Columns are allocated in fixed slabs that are never moved or freed while the pool
+// is alive, so a pointer from acquire stays valid until it is released no matter how the maps that refer to it grow.
+// Released columns are recycled by the next acquire. Not thread safe, acquire and release from the main thread only.
+class ChunkColumnPool {
+public:
+    ChunkColumnPool() = default;
+
+    ChunkColumnPool(const ChunkColumnPool&) = delete;
+    ChunkColumnPool& operator=(const ChunkColumnPool&) = delete;
+
+    // Returns an empty column at chunk_pos
+    [[nodiscard]] ChunkColumn* acquire(nnm::Vector2i chunk_pos);
+
+    void release(ChunkColumn* column);
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_slabs.size() * sc_slab_size - m_free.size();
+    }
+
+    [[nodiscard]] size_t capacity() const
+    {
+        return m_slabs.size() * sc_slab_size;
+    }
+
+private:
+    static constexpr size_t sc_slab_size = 64;
+
+    using Slab = std::array<ChunkColumn, sc_slab_size>;
+
+    std::vector<std::unique_ptr<Slab>> m_slabs {};
+    std::vector<ChunkColumn*> m_free {};
+};
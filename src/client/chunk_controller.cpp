@@ -1,12 +1,20 @@
 #include "chunk_controller.hpp"
 
+#include <algorithm>
 #include <ranges>
 
+#include "chunk_neighborhood.hpp"
+#include "light_engine.hpp"
 #include "world_data.hpp"
 #include "world_generator.hpp"
 #include "world_renderer.hpp"
 #include <game_performance_profiler.hpp>
 
+ChunkController::ChunkController(BS::thread_pool& light_thread_pool)
+    : m_light_scheduler(light_thread_pool)
+{
+}
+
 void ChunkController::update(
     WorldData& world_data,
     const WorldGenerator& world_generator,
@@ -21,10 +29,19 @@ void ChunkController::update(
         on_player_chunk_change();
     }
 
+    for (const nnm::Vector3i chunk_pos : m_remesh_chunks) {
+        // Columns without a mesh yet or already queued for a full remesh pick up the edit when they are meshed
+        if (const ChunkState* state = m_chunk_states.find(chunk_pos); state != nullptr
+            && contains_flag(state->flags, flag_has_mesh) && !contains_flag(state->flags, flag_queued_mesh)) {
+            world_renderer.push_mesh_update(chunk_pos, MeshUpdateKind::edit, state->lod);
+        }
+    }
+    m_remesh_chunks.clear();
+
     int chunk_count = 0;
+    int lod_column_count = 0;
     for (const nnm::Vector2i col_pos : m_sorted_chunks_in_range) {
-        auto& [flags, neighbors] = m_chunk_states.at(col_pos);
-        if (!contains_flag(flags, flag_is_generated)) {
+        if (!contains_flag(m_chunk_states.at(col_pos).flags, flag_is_generated)) {
             if (!world_data.contains_column(col_pos)) {
                 world_data.create_or_load_chunk(col_pos);
             }
@@ -33,18 +50,23 @@ void ChunkController::update(
                 world_data.queue_save_chunk(col_pos);
             }
             for (const nnm::Vector2i offset : sc_nbor_offsets) {
-                if (!m_chunk_states.contains(col_pos + offset)) {
-                    m_chunk_states.insert({ col_pos + offset, {} });
-                }
                 // ReSharper disable once CppUseStructuredBinding
-                ChunkState& neighbor_state = m_chunk_states.at(col_pos + offset);
+                ChunkState& neighbor_state = m_chunk_states[col_pos + offset];
                 neighbor_state.generated_neighbors++;
                 if (contains_flag(neighbor_state.flags, flag_is_generated)
                     && neighbor_state.generated_neighbors == sc_full_nbors) {
                     enable_flag(neighbor_state.flags, flag_queued_mesh);
                 }
             }
+        }
+        // Inserting neighbour states may have moved this state so it is looked up again
+        // ReSharper disable once CppUseStructuredBinding
+        auto& [flags, neighbors, lod] = m_chunk_states.at(col_pos);
+        if (!contains_flag(flags, flag_is_generated)) {
             enable_flag(flags, flag_is_generated);
+            // Loaded columns are lit again too, their saved light is missing anything that reached them from
+            // neighbours saved at a different time
+            m_new_columns.push_back(col_pos);
             if (neighbors == sc_full_nbors) {
                 enable_flag(flags, flag_queued_mesh);
             }
@@ -52,45 +74,60 @@ void ChunkController::update(
         }
 
         if (contains_flag(flags, flag_queued_mesh)) {
+            lod = column_lod(col_pos);
             for (int h = -10; h < 10; h++) {
-                world_renderer.push_mesh_update({ col_pos.x, col_pos.y, h });
+                world_renderer.push_mesh_update({ col_pos.x, col_pos.y, h }, MeshUpdateKind::streaming, lod);
             }
             enable_flag(flags, flag_has_mesh);
             disable_flag(flags, flag_queued_mesh);
+            disable_flag(flags, flag_queued_lod);
             chunk_count++;
         }
+        else if (contains_flag(flags, flag_queued_lod) && lod_column_count < sc_lod_columns_per_update) {
+            lod = column_lod(col_pos);
+            for (int h = -10; h < 10; h++) {
+                world_renderer.push_mesh_update({ col_pos.x, col_pos.y, h }, MeshUpdateKind::lod, lod);
+            }
+            disable_flag(flags, flag_queued_lod);
+            lod_column_count++;
+        }
         if (chunk_count > m_mesh_updates_per_frame) {
             break;
         }
     }
 
+    // Before meshing so the new columns are snapshotted with their light
+    light_new_columns(world_data, world_renderer);
     world_renderer.process_mesh_updates(world_data);
 
     chunk_count = 0;
     while (std::optional<nnm::Vector2i> culled_chunk
            = world_data.try_cull_chunk(static_cast<float>(m_render_distance) + 3.0f)) {
-        if (!m_chunk_states.contains(culled_chunk.value())) {
+        ChunkState* state = m_chunk_states.find(culled_chunk.value());
+        if (state == nullptr) {
             continue;
         }
-        uint8_t& flags = m_chunk_states.at(culled_chunk.value()).flags;
-        if (contains_flag(flags, flag_is_generated)) {
+        if (contains_flag(state->flags, flag_has_mesh)) {
+            for (int h = -10; h < 10; h++) {
+                world_renderer.remove_data({ culled_chunk.value().x, culled_chunk.value().y, h });
+            }
+            disable_flag(state->flags, flag_has_mesh);
+        }
+        disable_flag(state->flags, flag_queued_mesh);
+        disable_flag(state->flags, flag_queued_lod);
+
+        // Neighbour states are updated last since erasing them may move this state
+        if (contains_flag(state->flags, flag_is_generated)) {
+            disable_flag(state->flags, flag_is_generated);
             for (nnm::Vector2i offset : sc_nbor_offsets) {
-                if (const nnm::Vector2i neighbor = culled_chunk.value() + offset; m_chunk_states.contains(neighbor)) {
-                    if (--m_chunk_states.at(neighbor).generated_neighbors == 0) {
+                if (const nnm::Vector2i neighbor = culled_chunk.value() + offset;
+                    ChunkState* neighbor_state = m_chunk_states.find(neighbor)) {
+                    if (--neighbor_state->generated_neighbors == 0) {
                         m_chunk_states.erase(neighbor);
                     }
                 }
             }
-            disable_flag(flags, flag_is_generated);
-        }
-        if (contains_flag(flags, flag_has_mesh)) {
-            for (int h = -10; h < 10; h++) {
-                world_renderer.remove_data({ culled_chunk.value().x, culled_chunk.value().y, h });
-            }
-            disable_flag(flags, flag_has_mesh);
         }
-
-        disable_flag(flags, flag_queued_mesh);
         if (++chunk_count > m_mesh_updates_per_frame) {
             break;
         }
@@ -101,13 +138,146 @@ void ChunkController::update(
 void ChunkController::queue_recreate_mesh(const nnm::Vector2i chunk_pos)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    if (m_chunk_states.contains(chunk_pos)) {
-        if (uint8_t& flags = m_chunk_states.at(chunk_pos).flags;
-            contains_flag(flags, flag_is_generated) && contains_flag(flags, flag_has_mesh)) {
-            enable_flag(flags, flag_queued_mesh);
+    if (ChunkState* state = m_chunk_states.find(chunk_pos)) {
+        if (contains_flag(state->flags, flag_is_generated) && contains_flag(state->flags, flag_has_mesh)) {
+            enable_flag(state->flags, flag_queued_mesh);
+        }
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void ChunkController::queue_recreate_all_meshes()
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    for (auto& [_, state] : m_chunk_states) {
+        if (contains_flag(state.flags, flag_is_generated) && contains_flag(state.flags, flag_has_mesh)) {
+            enable_flag(state.flags, flag_queued_mesh);
+        }
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void ChunkController::light_new_columns(WorldData& world_data, WorldRenderer& world_renderer)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    if (m_new_columns.empty()) {
+        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+        return;
+    }
+    m_light_revisions.clear();
+    for (const nnm::Vector2i col_pos : m_new_columns) {
+        for_2d({ -1, -1 }, { 2, 2 }, [&](const nnm::Vector2i offset) {
+            const nnm::Vector2i neighbor = col_pos + offset;
+            const ChunkState* state = m_chunk_states.find(neighbor);
+            if (state == nullptr || !contains_flag(state->flags, flag_has_mesh)) {
+                return;
+            }
+            // Neighbours shared by several new columns are only recorded once
+            if (std::ranges::any_of(m_light_revisions, [&](const std::pair<nnm::Vector3i, uint32_t>& entry) {
+                    return entry.first.x == neighbor.x && entry.first.y == neighbor.y;
+                })) {
+                return;
+            }
+            for (int h = -10; h < 10; ++h) {
+                const nnm::Vector3i chunk_pos { neighbor.x, neighbor.y, h };
+                m_light_revisions.emplace_back(chunk_pos, world_data.chunk_data_at(chunk_pos).light_revision());
+            }
+        });
+    }
+
+    m_light_scheduler.light_new_columns(world_data, m_new_columns);
+    m_new_columns.clear();
+
+    for (const auto& [chunk_pos, revision] : m_light_revisions) {
+        if (world_data.chunk_data_at(chunk_pos).light_revision() != revision) {
+            // Streaming rather than edit priority, light spreading in from new terrain is not worth delaying the
+            // terrain for
+            world_renderer.push_mesh_update(
+                chunk_pos, MeshUpdateKind::streaming, m_chunk_states.at(nnm::Vector2i(chunk_pos.x, chunk_pos.y)).lod);
+        }
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+// Brightest of the sky and block light packed in a byte, this is what chunk meshes sample
+static uint8_t rendered_light(const uint8_t packed_light)
+{
+    return std::max<uint8_t>(packed_light & 0x0F, packed_light >> 4);
+}
+
+// Bit i is set for every chunk at offset (i % 3 - 1, i / 3 % 3 - 1, i / 9 - 1) whose mesh samples the voxel at
+// local_pos, which is the chunk itself and every neighbour whose one voxel apron holds it
+static uint32_t sampling_chunks_mask(const nnm::Vector3i local_pos)
+{
+    constexpr uint32_t self_bit = 1u << 13;
+    auto axis_offsets = [](const int value) -> uint32_t {
+        return 0b010u | (value == 0 ? 0b001u : 0u) | (value == 15 ? 0b100u : 0u);
+    };
+    const uint32_t x = axis_offsets(local_pos.x);
+    const uint32_t y = axis_offsets(local_pos.y);
+    const uint32_t z = axis_offsets(local_pos.z);
+    if ((x | y | z) == 0b010u) {
+        return self_bit;
+    }
+    uint32_t mask = 0;
+    for (int i = 0; i < 27; ++i) {
+        if ((x >> (i % 3) & 1) != 0 && (y >> (i / 3 % 3) & 1) != 0 && (z >> (i / 9) & 1) != 0) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+int ChunkController::queue_block_edit(
+    const WorldData& world_data, const nnm::Vector3i block_pos, const LightEngine& light_engine)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    m_edit_chunks.clear();
+    queue_edit_chunks(
+        world_data, chunk_pos_from_block_pos(block_pos), sampling_chunks_mask(block_world_to_local(block_pos)));
+
+    // The changes are grouped by chunk so the chunks sampling them are gathered per chunk
+    const std::span<const LightEngine::LightChange> light_changes = light_engine.last_update_light_changes();
+    for (size_t begin = 0; begin < light_changes.size();) {
+        const nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(light_changes[begin].block_pos);
+        const ChunkData& chunk_data = world_data.chunk_data_at(chunk_pos);
+        uint32_t mask = 0;
+        size_t end = begin;
+        for (; end < light_changes.size() && chunk_pos_from_block_pos(light_changes[end].block_pos) == chunk_pos;
+             ++end) {
+            const nnm::Vector3i local_pos = block_world_to_local(light_changes[end].block_pos);
+            // Only the brighter channel is drawn, a change in the other one leaves the meshes as they are
+            const uint8_t light = std::max(chunk_data.sky_light_at(local_pos), chunk_data.block_light_at(local_pos));
+            if (light != rendered_light(light_changes[end].packed_light_before)) {
+                mask |= sampling_chunks_mask(local_pos);
+            }
         }
+        queue_edit_chunks(world_data, chunk_pos, mask);
+        begin = end;
     }
+
+    for (const nnm::Vector3i chunk_pos : m_edit_chunks) {
+        if (std::ranges::find(m_remesh_chunks, chunk_pos) == m_remesh_chunks.end()) {
+            m_remesh_chunks.push_back(chunk_pos);
+        }
+    }
+    m_last_edit_remesh_count = static_cast<int>(m_edit_chunks.size());
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    return m_last_edit_remesh_count;
+}
+
+void ChunkController::queue_edit_chunks(
+    const WorldData& world_data, const nnm::Vector3i chunk_pos, const uint32_t neighbor_mask)
+{
+    for (int i = 0; i < 27; ++i) {
+        if ((neighbor_mask >> i & 1) == 0) {
+            continue;
+        }
+        if (const nnm::Vector3i pos = chunk_pos + nnm::Vector3i(i % 3 - 1, i / 3 % 3 - 1, i / 9 - 1);
+            world_data.contains_chunk(pos) && std::ranges::find(m_edit_chunks, pos) == m_edit_chunks.end()) {
+            m_edit_chunks.push_back(pos);
+        }
+    }
 }
 
 void ChunkController::on_player_chunk_change()
@@ -121,12 +291,10 @@ void ChunkController::on_player_chunk_change()
         [&](const nnm::Vector2i pos) {
             if (nnm::abs(nnm::sqrd(pos.x - m_player_chunk_col.x) + nnm::sqrd(pos.y - m_player_chunk_col.y))
                 <= nnm::sqrd(m_render_distance)) {
-                if (!m_chunk_states.contains(pos)) {
-                    m_chunk_states[pos] = {};
-                }
+                m_chunk_states.try_emplace(pos);
             }
         });
-    for (const auto& pos : m_chunk_states | std::views::keys) {
+    for (const auto& [pos, _] : m_chunk_states) {
         m_sorted_chunks_in_range.push_back(pos);
     }
     std::ranges::sort(m_sorted_chunks_in_range, [&](const nnm::Vector2i& a, const nnm::Vector2i& b) {
@@ -135,5 +303,38 @@ void ChunkController::on_player_chunk_change()
             < nnm::Vector2f(b).distance_sqrd(
                 nnm::Vector2(static_cast<float>(m_player_chunk_col.x), static_cast<float>(m_player_chunk_col.y)));
     });
+
+    // Columns that crossed into another ring or border one that did are remeshed, their current mesh stays until the
+    // new one is uploaded so there is no gap during the transition. Columns that moved back to the level they are
+    // meshed at before their turn came are left alone.
+    for (auto& [pos, state] : m_chunk_states) {
+        if (contains_flag(state.flags, flag_has_mesh) && column_lod(pos) != state.lod) {
+            enable_flag(state.flags, flag_queued_lod);
+        }
+        else {
+            disable_flag(state.flags, flag_queued_lod);
+        }
+    }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
+
+int ChunkController::lod_level(const nnm::Vector2i col_pos) const
+{
+    const int dist_sqrd = nnm::sqrd(col_pos.x - m_player_chunk_col.x) + nnm::sqrd(col_pos.y - m_player_chunk_col.y);
+    return static_cast<int>(
+        std::ranges::count_if(m_lod_distances, [&](const int distance) { return dist_sqrd > nnm::sqrd(distance); }));
+}
+
+ChunkLod ChunkController::column_lod(const nnm::Vector2i col_pos) const
+{
+    static const std::array<std::pair<nnm::Vector2i, ChunkSideBits>, 4> sc_sides {
+        { { { -1, 0 }, side_neg_x }, { { 1, 0 }, side_pos_x }, { { 0, -1 }, side_neg_y }, { { 0, 1 }, side_pos_y } }
+    };
+    ChunkLod lod { .level = lod_level(col_pos), .skirt_sides = 0 };
+    for (const auto& [offset, side] : sc_sides) {
+        if (lod_level(col_pos + offset) != lod.level) {
+            lod.skirt_sides |= side;
+        }
+    }
+    return lod;
+}
@@ -2,19 +2,25 @@
 
 #include <array>
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
+#include "chunk_map.hpp"
+#include "chunk_mesh.hpp"
 #include "common.hpp"
+#include "light_scheduler.hpp"
 
 #include <nnm/nnm.hpp>
 
+class LightEngine;
 class WorldData;
 class WorldGenerator;
 class WorldRenderer;
 
 class ChunkController {
 public:
+    // Generated columns are lit on light_thread_pool
+    explicit ChunkController(BS::thread_pool& light_thread_pool);
+
     void update(
         WorldData& world_data,
         const WorldGenerator& world_generator,
@@ -33,13 +39,40 @@ public:
         return *this;
     }
 
+    // Columns further than distances[i] columns from the player are meshed at level of detail i + 1, the distances
+    // should be increasing. Levels only change by one between neighbouring rings when the rings are at least a column
+    // apart, which is what the skirts between levels are sized for.
+    ChunkController& set_lod_distances(const std::array<int, sc_max_lod_level>& distances)
+    {
+        m_lod_distances = distances;
+        // Forces the rings to be reevaluated on the next update
+        m_player_chunk_col = { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+        return *this;
+    }
+
     void queue_recreate_mesh(nnm::Vector2i chunk_pos);
 
+    void queue_recreate_all_meshes();
+
+    // A single block edit only remeshes the chunks it can change instead of whole columns. Call once the block at
+    // block_pos is set and light_engine updated the light around it. The edited chunk is queued along with the
+    // neighbours whose mesh samples the block, which are only the face neighbours unless the block sits on a chunk edge
+    // or corner. The voxels whose rendered light the update changed queue the chunks sampling them the same way.
+    // Returns the number of chunks queued for the edit.
+    int queue_block_edit(const WorldData& world_data, nnm::Vector3i block_pos, const LightEngine& light_engine);
+
+    [[nodiscard]] int last_edit_remesh_count() const
+    {
+        return m_last_edit_remesh_count;
+    }
+
 private:
     enum ChunkFlagBits {
         flag_has_mesh = 1 << 0,
         flag_is_generated = 1 << 1,
         flag_queued_mesh = 1 << 2,
+        // The column has a mesh at a level of detail it is no longer at
+        flag_queued_lod = 1 << 3,
     };
 
     template <typename T, typename U>
@@ -63,16 +96,42 @@ private:
     struct ChunkState {
         uint8_t flags {};
         int generated_neighbors = 0;
+        // Level of detail the column was last meshed at
+        ChunkLod lod {};
     };
 
     void on_player_chunk_change();
 
+    [[nodiscard]] int lod_level(nnm::Vector2i col_pos) const;
+
+    // Level of detail of the column with skirts on every side facing a column at another level
+    [[nodiscard]] ChunkLod column_lod(nnm::Vector2i col_pos) const;
+
+    void queue_edit_chunks(const WorldData& world_data, nnm::Vector3i chunk_pos, uint32_t neighbor_mask);
+
+    // Lights the columns generated or loaded this update together with the light the lit columns around them spread
+    // in. Their light spreads into the neighbouring columns, chunks of those that already have a mesh are remeshed if
+    // it reached them.
+    void light_new_columns(WorldData& world_data, WorldRenderer& world_renderer);
+
+    // Columns remeshed for a change of level of detail per update on top of the streaming ones. Their old mesh stays
+    // drawn meanwhile, so these only need to keep up with the player crossing rings.
+    static constexpr int sc_lod_columns_per_update = 1;
+
     inline static const std::array<nnm::Vector2i, 4> sc_nbor_offsets { { { 0, 1 }, { 0, -1 }, { 1, 0 }, { -1, 0 } } };
     static constexpr int sc_full_nbors = sc_nbor_offsets.size();
 
     nnm::Vector2i m_player_chunk_col = { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
     std::vector<nnm::Vector2i> m_sorted_chunks_in_range {};
-    std::unordered_map<nnm::Vector2i, ChunkState> m_chunk_states;
+    ChunkMap<nnm::Vector2i, ChunkState> m_chunk_states;
     int m_render_distance = 0;
     int m_mesh_updates_per_frame = 0;
+    std::array<int, sc_max_lod_level> m_lod_distances { 8, 16, 24 };
+    LightScheduler m_light_scheduler;
+    std::vector<nnm::Vector2i> m_new_columns {};
+    // Meshed chunks next to the new columns with their light revision from before lighting them
+    std::vector<std::pair<nnm::Vector3i, uint32_t>> m_light_revisions {};
+    std::vector<nnm::Vector3i> m_edit_chunks;
+    std::vector<nnm::Vector3i> m_remesh_chunks;
+    int m_last_edit_remesh_count = 0;
 };
\ No newline at end of file
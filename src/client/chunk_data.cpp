@@ -15,12 +15,11 @@ void ChunkData::set_block(const nnm::Vector3i pos, const uint8_t type)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     VV_DEB_ASSERT(is_block_pos_local(pos), "[ChunkData] Invalid local block position");
-    if (m_block_data[index(pos)] == 0 && type != 0) {
+    if (const uint8_t prev_type = m_blocks.set(index(pos), type); prev_type == 0 && type != 0) {
         m_block_count++;
     }
-    else if (m_block_data[index(pos)] != 0 && type == 0) {
+    else if (prev_type != 0 && type == 0) {
         m_block_count--;
     }
-    m_block_data[index(pos)] = type;
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
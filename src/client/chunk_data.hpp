@@ -2,6 +2,8 @@
 
 #include <array>
 #include <cstdint>
+#include <optional>
+#include <vector>
 
 // ReSharper disable once CppUnusedIncludeDirective
 #include <cereal/types/array.hpp>
@@ -13,6 +15,8 @@
 #include <nnm/nnm.hpp>
 
 #include "../common/assert.hpp"
+#include "block_storage.hpp"
+#include "light_storage.hpp"
 
 inline nnm::Vector3i direction_vector(const Direction dir)
 {
@@ -60,9 +64,32 @@ public:
 
     explicit ChunkData(nnm::Vector3i chunk_pos);
 
-    void reset_lighting(const uint8_t value = 0)
+    // Empty chunk with no light, the same as a default constructed one apart from the position
+    void reset()
     {
-        std::ranges::fill(m_lighting_data, value);
+        m_blocks.fill(0);
+        m_lighting.reset(0, 0);
+        ++m_light_revision;
+        m_block_count = 0;
+    }
+
+    // Makes lighting uniform which releases the per-voxel lighting array
+    void reset_lighting(const uint8_t sky = 0, const uint8_t block = 0)
+    {
+        m_lighting.reset(sky, block);
+        ++m_light_revision;
+    }
+
+    void fill_sky_light(const uint8_t value)
+    {
+        m_lighting.fill_sky(value);
+        ++m_light_revision;
+    }
+
+    void fill_block_light(const uint8_t value)
+    {
+        m_lighting.fill_block(value);
+        ++m_light_revision;
     }
 
     [[nodiscard]] nnm::Vector3i position() const
@@ -74,20 +101,87 @@ public:
     [[nodiscard]] uint8_t get_block(const nnm::Vector3i pos) const
     {
         VV_DEB_ASSERT(is_block_pos_local(pos), "[ChunkData] Invalid local block position");
-        return m_block_data[index(pos)];
+        return m_blocks.get(index(pos));
+    }
+
+    void set_sky_light(const nnm::Vector3i pos, const uint8_t val)
+    {
+        VV_DEB_ASSERT(is_block_pos_local(pos), "[ChunkData] Invalid local block position");
+        m_lighting.set_sky(index(pos), val);
+        ++m_light_revision;
     }
 
-    void set_lighting(const nnm::Vector3i pos, const uint8_t val)
+    void set_block_light(const nnm::Vector3i pos, const uint8_t val)
     {
         VV_DEB_ASSERT(is_block_pos_local(pos), "[ChunkData] Invalid local block position");
-        VV_DEB_ASSERT(val <= 15, "[ChunkData] Lighting is not between 0 and 15")
-        m_lighting_data[index(pos)] = val;
+        m_lighting.set_block(index(pos), val);
+        ++m_light_revision;
     }
 
+    // Sets the sky light of the voxels of the block column at col from z_begin up to but not including z_end
+    void set_sky_light_span(const nnm::Vector2i col, const int z_begin, const int z_end, const uint8_t val)
+    {
+        VV_DEB_ASSERT(is_block_pos_local_col(col) && z_begin >= 0 && z_end <= 16, "[ChunkData] Invalid block span");
+        for (int z = z_begin; z < z_end; ++z) {
+            m_lighting.set_sky(index({ col.x, col.y, z }), val);
+        }
+        ++m_light_revision;
+    }
+
+    [[nodiscard]] uint8_t sky_light_at(const nnm::Vector3i pos) const
+    {
+        VV_DEB_ASSERT(is_block_pos_local(pos), "[ChunkData] Invalid local block position");
+        return m_lighting.sky(index(pos));
+    }
+
+    [[nodiscard]] uint8_t block_light_at(const nnm::Vector3i pos) const
+    {
+        VV_DEB_ASSERT(is_block_pos_local(pos), "[ChunkData] Invalid local block position");
+        return m_lighting.block(index(pos));
+    }
+
+    [[nodiscard]] uint8_t light_at(const LightChannel channel, const nnm::Vector3i pos) const
+    {
+        return channel == LightChannel::sky ? sky_light_at(pos) : block_light_at(pos);
+    }
+
+    void set_light(const LightChannel channel, const nnm::Vector3i pos, const uint8_t val)
+    {
+        if (channel == LightChannel::sky) {
+            set_sky_light(pos, val);
+        }
+        else {
+            set_block_light(pos, val);
+        }
+    }
+
+    // Brightest of sky and block light
     [[nodiscard]] uint8_t lighting_at(const nnm::Vector3i pos) const
     {
         VV_DEB_ASSERT(is_block_pos_local(pos), "[ChunkData] Invalid local block position");
-        return m_lighting_data[index(pos)];
+        return m_lighting.combined(index(pos));
+    }
+
+    [[nodiscard]] std::optional<uint8_t> uniform_block() const
+    {
+        if (!m_blocks.is_uniform()) {
+            return {};
+        }
+        return m_blocks.get(0);
+    }
+
+    [[nodiscard]] std::optional<uint8_t> uniform_sky_light() const
+    {
+        if (const std::optional<uint8_t> packed = m_lighting.uniform(); packed.has_value()) {
+            return *packed & 0x0F;
+        }
+        return {};
+    }
+
+    // All one block type with constant light, no per-voxel arrays are allocated
+    [[nodiscard]] bool is_uniform() const
+    {
+        return m_blocks.is_uniform() && m_lighting.is_uniform();
     }
 
     [[nodiscard]] int block_count() const
@@ -95,10 +189,31 @@ public:
         return m_block_count;
     }
 
+    [[nodiscard]] const BlockStorage& blocks() const
+    {
+        return m_blocks;
+    }
+
+    [[nodiscard]] const LightStorage& lighting() const
+    {
+        return m_lighting;
+    }
+
+    // Changes whenever light is written to the chunk, even if the values stay the same. Not saved.
+    [[nodiscard]] uint32_t light_revision() const
+    {
+        return m_light_revision;
+    }
+
+    [[nodiscard]] size_t heap_memory_usage() const
+    {
+        return m_blocks.memory_usage() + m_lighting.memory_usage();
+    }
+
     template <class Archive>
     void serialize(Archive& archive)
     {
-        archive(m_pos, m_block_data, m_lighting_data, m_block_count);
+        archive(m_pos, m_blocks, m_lighting, m_block_count);
     }
 
 private:
@@ -131,7 +246,8 @@ private:
 
     static constexpr int sc_chunk_size = 16;
     nnm::Vector3i m_pos;
-    std::array<uint8_t, sc_chunk_size * sc_chunk_size * sc_chunk_size> m_block_data = { 0 };
-    std::array<uint8_t, sc_chunk_size * sc_chunk_size * sc_chunk_size> m_lighting_data = { 0 };
+    BlockStorage m_blocks;
+    LightStorage m_lighting;
     int m_block_count = 0;
+    uint32_t m_light_revision = 0;
 };
\ No newline at end of file
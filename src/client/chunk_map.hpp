@@ -0,0 +1,298 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nnm/nnm.hpp>
+
+#include "../common/assert.hpp"
+
+inline uint64_t chunk_hash(const nnm::Vector2i pos)
+{
+    // Multiply each coordinate by a large odd constant so neighbouring chunks land far apart, the top bits are used
+    // for the slot index
+    return static_cast<uint64_t>(static_cast<uint32_t>(pos.x)) * 0x9E3779B97F4A7C15ull
+        ^ static_cast<uint64_t>(static_cast<uint32_t>(pos.y)) * 0xC2B2AE3D27D4EB4Full;
+}
+
+inline uint64_t chunk_hash(const nnm::Vector3i pos)
+{
+    return chunk_hash(nnm::Vector2i(pos.x, pos.y))
+        ^ static_cast<uint64_t>(static_cast<uint32_t>(pos.z)) * 0x165667B19E3779F9ull;
+}
+
+// Open-addressing hash map keyed by integer chunk coordinates. Slots are stored inline with linear probing so a
+// lookup is a single probe sequence over contiguous memory. Columns keyed by Vector2i can also be looked up directly
+// with a chunk or block position as Vector3i.
+// Pointers and references to values are invalidated by any insertion or erasure.
+template <typename Key, typename Value>
+class ChunkMap {
+public:
+    using Entry = std::pair<Key, Value>;
+
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using SlotIterator = std::conditional_t<
+            IsConst,
+            typename std::vector<std::optional<Entry>>::const_iterator,
+            typename std::vector<std::optional<Entry>>::iterator>;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const Entry*, Entry*>;
+        using reference = std::conditional_t<IsConst, const Entry&, Entry&>;
+
+        Iterator() = default;
+
+        Iterator(const SlotIterator current, const SlotIterator end)
+            : m_current(current)
+            , m_end(end)
+        {
+            skip_empty();
+        }
+
+        reference operator*() const
+        {
+            return **m_current;
+        }
+
+        pointer operator->() const
+        {
+            return &**m_current;
+        }
+
+        Iterator& operator++()
+        {
+            ++m_current;
+            skip_empty();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator prev = *this;
+            ++*this;
+            return prev;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return m_current == other.m_current;
+        }
+
+    private:
+        void skip_empty()
+        {
+            while (m_current != m_end && !m_current->has_value()) {
+                ++m_current;
+            }
+        }
+
+        SlotIterator m_current {};
+        SlotIterator m_end {};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    template <typename Lookup>
+    [[nodiscard]] Value* find(const Lookup& lookup)
+    {
+        const std::optional<size_t> index = find_index(to_key(lookup));
+        return index.has_value() ? &m_slots[*index]->second : nullptr;
+    }
+
+    template <typename Lookup>
+    [[nodiscard]] const Value* find(const Lookup& lookup) const
+    {
+        const std::optional<size_t> index = find_index(to_key(lookup));
+        return index.has_value() ? &m_slots[*index]->second : nullptr;
+    }
+
+    template <typename Lookup>
+    [[nodiscard]] bool contains(const Lookup& lookup) const
+    {
+        return find(lookup) != nullptr;
+    }
+
+    template <typename Lookup>
+    [[nodiscard]] Value& at(const Lookup& lookup)
+    {
+        Value* value = find(lookup);
+        VV_REL_ASSERT(value != nullptr, "[ChunkMap] Key not found")
+        return *value;
+    }
+
+    template <typename Lookup>
+    [[nodiscard]] const Value& at(const Lookup& lookup) const
+    {
+        const Value* value = find(lookup);
+        VV_REL_ASSERT(value != nullptr, "[ChunkMap] Key not found")
+        return *value;
+    }
+
+    // Returns the value at key and whether it was inserted, an existing value is left untouched
+    template <typename... Args>
+    std::pair<Value*, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        if (Value* value = find(key)) {
+            return { value, false };
+        }
+        if ((m_size + 1) * sc_max_load_den > m_slots.size() * sc_max_load_num) {
+            rehash(std::max<size_t>(sc_min_capacity, m_slots.size() * 2));
+        }
+        size_t i = home_index(key);
+        while (m_slots[i].has_value()) {
+            i = next_index(i);
+        }
+        m_slots[i].emplace(
+            std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        ++m_size;
+        return { &m_slots[i]->second, true };
+    }
+
+    Value& operator[](const Key& key)
+    {
+        return *try_emplace(key).first;
+    }
+
+    // Removes key by shifting the rest of its probe sequence back, no tombstones are left behind
+    bool erase(const Key& key)
+    {
+        const std::optional<size_t> index = find_index(key);
+        if (!index.has_value()) {
+            return false;
+        }
+        size_t hole = *index;
+        m_slots[hole].reset();
+        --m_size;
+        for (size_t i = next_index(hole); m_slots[i].has_value(); i = next_index(i)) {
+            // An entry can fill the hole if the hole lies between its home slot and where it currently is
+            if (const size_t home = home_index(m_slots[i]->first); probe_distance(home, i) >= probe_distance(hole, i)) {
+                m_slots[hole] = std::move(m_slots[i]);
+                m_slots[i].reset();
+                hole = i;
+            }
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        for (std::optional<Entry>& slot : m_slots) {
+            slot.reset();
+        }
+        m_size = 0;
+    }
+
+    void reserve(const size_t count)
+    {
+        if (count * sc_max_load_den > m_slots.size() * sc_max_load_num) {
+            rehash(std::bit_ceil(std::max<size_t>(sc_min_capacity, count * sc_max_load_den / sc_max_load_num + 1)));
+        }
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    iterator begin()
+    {
+        return { m_slots.begin(), m_slots.end() };
+    }
+
+    iterator end()
+    {
+        return { m_slots.end(), m_slots.end() };
+    }
+
+    const_iterator begin() const
+    {
+        return { m_slots.cbegin(), m_slots.cend() };
+    }
+
+    const_iterator end() const
+    {
+        return { m_slots.cend(), m_slots.cend() };
+    }
+
+private:
+    static constexpr size_t sc_min_capacity = 16;
+    static constexpr size_t sc_max_load_num = 3;
+    static constexpr size_t sc_max_load_den = 4;
+
+    static Key to_key(const Key& key)
+    {
+        return key;
+    }
+
+    static Key to_key(const nnm::Vector3i& pos)
+        requires std::same_as<Key, nnm::Vector2i>
+    {
+        return { pos.x, pos.y };
+    }
+
+    [[nodiscard]] std::optional<size_t> find_index(const Key& key) const
+    {
+        if (m_slots.empty()) {
+            return {};
+        }
+        for (size_t i = home_index(key); m_slots[i].has_value(); i = next_index(i)) {
+            if (m_slots[i]->first == key) {
+                return i;
+            }
+        }
+        return {};
+    }
+
+    [[nodiscard]] size_t home_index(const Key& key) const
+    {
+        return static_cast<size_t>(chunk_hash(key) >> m_shift);
+    }
+
+    [[nodiscard]] size_t next_index(const size_t index) const
+    {
+        return (index + 1) & (m_slots.size() - 1);
+    }
+
+    [[nodiscard]] size_t probe_distance(const size_t from, const size_t to) const
+    {
+        return (to - from) & (m_slots.size() - 1);
+    }
+
+    void rehash(const size_t capacity)
+    {
+        VV_DEB_ASSERT(std::has_single_bit(capacity), "[ChunkMap] Capacity must be a power of two")
+        std::vector<std::optional<Entry>> old_slots = std::move(m_slots);
+        m_slots = std::vector<std::optional<Entry>>(capacity);
+        m_shift = 64 - std::countr_zero(capacity);
+        for (std::optional<Entry>& slot : old_slots) {
+            if (slot.has_value()) {
+                size_t i = home_index(slot->first);
+                while (m_slots[i].has_value()) {
+                    i = next_index(i);
+                }
+                m_slots[i] = std::move(slot);
+            }
+        }
+    }
+
+    std::vector<std::optional<Entry>> m_slots {};
+    size_t m_size = 0;
+    int m_shift = 64;
+};
@@ -1,457 +1,471 @@
 #include "chunk_mesh.hpp"
 
+#include <algorithm>
+#include <bit>
+
 #include "common.hpp"
 
 #include <nnm/nnm.hpp>
 
 #include "chunk_data.hpp"
+#include "chunk_mesh_pool.hpp"
+#include "chunk_neighborhood.hpp"
 #include "world_data.hpp"
-#include "world_renderer.hpp"
 #include <game_performance_profiler.hpp>
 
-void combine_mesh_data(ChunkMeshData& data, const ChunkMeshData& other)
-{
-    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    const uint32_t indices_offset = data.vertices.size();
-    for (int i = 0; i < other.vertices.size(); i++) {
-        data.vertices.push_back(other.vertices[i]);
-        data.colors.push_back(other.colors[i]);
-        data.uvs.push_back(other.uvs[i]);
-    }
-
-    for (const unsigned int index : other.indices) {
-        data.indices.push_back(index + indices_offset);
-    }
-    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-}
-
-std::array<uint8_t, 4> calc_chunk_face_lighting(
-    const WorldData& data,
-    const ChunkData& chunk_data,
-    const nnm::Vector3i chunk_pos,
-    const nnm::Vector3i local_block_pos,
-    const Direction dir)
-{
-    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    const nnm::Vector3i world_pos = block_local_to_world(chunk_pos, local_block_pos);
-
-    uint8_t base_lighting = 0;
-
-    // format of check_blocks
+// Neighbours a face looks at for smooth lighting and ambient occlusion, as index steps in a ChunkNeighborhood from the
+// block the face belongs to
+struct FaceLightingOffsets {
+    // Voxel the face looks into, its light is shared by all four corners
+    int facing;
+    // Ring of the eight voxels around facing in the plane of the face, in the order
     //      0 | 1 | 2
     //      ---------
     //      7 |   | 3
     //      ---------
     //      6 | 5 | 4
-    std::array<nnm::Vector3i, 8> check_blocks;
-    switch (dir) {
-    case Direction::front:
-        base_lighting = data.lighting_at(world_pos + nnm::Vector3i(0, -1, 0)).value();
-        check_blocks[0] = { -1, -1, 1 };
-        check_blocks[1] = { 0, -1, 1 };
-        check_blocks[2] = { 1, -1, 1 };
-        check_blocks[3] = { 1, -1, 0 };
-        check_blocks[4] = { 1, -1, -1 };
-        check_blocks[5] = { 0, -1, -1 };
-        check_blocks[6] = { -1, -1, -1 };
-        check_blocks[7] = { -1, -1, 0 };
-        break;
-    case Direction::back:
-        base_lighting = data.lighting_at(world_pos + nnm::Vector3i(0, 1, 0)).value();
-        check_blocks[0] = { 1, 1, 1 };
-        check_blocks[1] = { 0, 1, 1 };
-        check_blocks[2] = { -1, 1, 1 };
-        check_blocks[3] = { -1, 1, 0 };
-        check_blocks[4] = { -1, 1, -1 };
-        check_blocks[5] = { 0, 1, -1 };
-        check_blocks[6] = { 1, 1, -1 };
-        check_blocks[7] = { 1, 1, 0 };
-        break;
-    case Direction::left:
-        base_lighting = data.lighting_at(world_pos + nnm::Vector3i(-1, 0, 0)).value();
-        check_blocks[0] = { -1, 1, 1 };
-        check_blocks[1] = { -1, 0, 1 };
-        check_blocks[2] = { -1, -1, 1 };
-        check_blocks[3] = { -1, -1, 0 };
-        check_blocks[4] = { -1, -1, -1 };
-        check_blocks[5] = { -1, 0, -1 };
-        check_blocks[6] = { -1, 1, -1 };
-        check_blocks[7] = { -1, 1, 0 };
-        break;
-    case Direction::right:
-        base_lighting = data.lighting_at(world_pos + nnm::Vector3i(1, 0, 0)).value();
-        check_blocks[0] = { 1, -1, 1 };
-        check_blocks[1] = { 1, 0, 1 };
-        check_blocks[2] = { 1, 1, 1 };
-        check_blocks[3] = { 1, 1, 0 };
-        check_blocks[4] = { 1, 1, -1 };
-        check_blocks[5] = { 1, 0, -1 };
-        check_blocks[6] = { 1, -1, -1 };
-        check_blocks[7] = { 1, -1, 0 };
-        break;
-    case Direction::top:
-        base_lighting = data.lighting_at(world_pos + nnm::Vector3i(0, 0, 1)).value();
-        check_blocks[0] = { -1, 1, 1 };
-        check_blocks[1] = { 0, 1, 1 };
-        check_blocks[2] = { 1, 1, 1 };
-        check_blocks[3] = { 1, 0, 1 };
-        check_blocks[4] = { 1, -1, 1 };
-        check_blocks[5] = { 0, -1, 1 };
-        check_blocks[6] = { -1, -1, 1 };
-        check_blocks[7] = { -1, 0, 1 };
-        break;
-    case Direction::bottom:
-        base_lighting = data.lighting_at(world_pos + nnm::Vector3i(0, 0, -1)).value();
-        check_blocks[0] = { 1, 1, -1 };
-        check_blocks[1] = { 0, 1, -1 };
-        check_blocks[2] = { -1, 1, -1 };
-        check_blocks[3] = { -1, 0, -1 };
-        check_blocks[4] = { -1, -1, -1 };
-        check_blocks[5] = { 0, -1, -1 };
-        check_blocks[6] = { 1, -1, -1 };
-        check_blocks[7] = { 1, 0, -1 };
-        break;
-    }
+    // so that corner i of the face touches ring voxels 2i - 1, 2i and 2i + 1
+    std::array<int, 8> ring;
+};
 
-    VV_DEB_ASSERT(base_lighting >= 0 && base_lighting <= 15, "[ChunkMesh] Base lighting is not between 0 and 15")
-
-    // format of adj_light
-    //      0 | 1 |        | 0 | 1      |   |        |   |
-    //      ---------    ---------    ---------    ---------
-    //      2 | 3 |        | 2 | 3      | 0 | 1    0 | 1 |
-    //      ---------    ---------    ---------    ---------
-    //        |   |        |   |        | 2 | 3    2 | 3 |
-    std::array<std::array<std::optional<int>, 4>, 4> adj_light {
-        { { std::nullopt, std::nullopt, std::nullopt, base_lighting },
-          { std::nullopt, std::nullopt, base_lighting, std::nullopt },
-          { base_lighting, std::nullopt, std::nullopt, std::nullopt },
-          { std::nullopt, base_lighting, std::nullopt, std::nullopt } }
+// Generated from the face normal and the two in-plane axes, u runs from the face's corner 0 to corner 1 and v from
+// corner 3 to corner 0, see create_chunk_face_mesh
+constexpr std::array<FaceLightingOffsets, 6> sc_face_lighting_offsets = [] {
+    struct FaceAxes {
+        nnm::Vector3i normal;
+        nnm::Vector3i u;
+        nnm::Vector3i v;
     };
-
-    for (int i = 0; i < check_blocks.size(); ++i) {
-        const nnm::Vector3i check_block_local = local_block_pos + check_blocks[i];
-        std::optional<uint8_t> check_block;
-        if (is_block_pos_local(check_block_local)) {
-            check_block = chunk_data.get_block(check_block_local);
-        }
-        else {
-            check_block = data.block_at_relative(chunk_pos, check_block_local);
-        }
-        if (!check_block.has_value()) {
-            continue;
-        }
-        if (is_transparent(*check_block)) {
-            std::optional<uint8_t> block_light;
-            if (is_block_pos_local(check_block_local)) {
-                block_light = chunk_data.lighting_at(check_block_local);
-            }
-            else {
-                block_light = data.lighting_at_relative(chunk_pos, check_block_local);
-            }
-            if (block_light.has_value()) {
-                switch (i) {
-                case 0:
-                    adj_light[0][0] = *block_light;
-                    break;
-                case 1:
-                    adj_light[0][1] = *block_light;
-                    adj_light[1][0] = *block_light;
-                    break;
-                case 2:
-                    adj_light[1][1] = *block_light;
-                    break;
-                case 3:
-                    adj_light[1][3] = *block_light;
-                    adj_light[2][1] = *block_light;
-                    break;
-                case 4:
-                    adj_light[2][3] = *block_light;
-                    break;
-                case 5:
-                    adj_light[2][2] = *block_light;
-                    adj_light[3][3] = *block_light;
-                    break;
-                case 6:
-                    adj_light[3][2] = *block_light;
-                    break;
-                case 7:
-                    adj_light[0][2] = *block_light;
-                    adj_light[3][0] = *block_light;
-                    break;
-                default:
-                    VV_REL_ASSERT(false, "Unreachable")
-                }
-            }
+    // Indexed by Direction
+    constexpr std::array<FaceAxes, 6> face_axes { { { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+                                                    { { 0, 1, 0 }, { -1, 0, 0 }, { 0, 0, 1 } },
+                                                    { { -1, 0, 0 }, { 0, -1, 0 }, { 0, 0, 1 } },
+                                                    { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },
+                                                    { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } },
+                                                    { { 0, 0, -1 }, { -1, 0, 0 }, { 0, 1, 0 } } } };
+    std::array<FaceLightingOffsets, 6> offsets {};
+    for (int face = 0; face < 6; ++face) {
+        const auto [normal, u, v] = face_axes[face];
+        const std::array<nnm::Vector3i, 8> ring { v - u, v, v + u, u, u - v, -v, -v - u, -u };
+        offsets[face].facing = ChunkNeighborhood::stride(normal);
+        for (int i = 0; i < 8; ++i) {
+            offsets[face].ring[i] = ChunkNeighborhood::stride(normal + ring[i]);
         }
     }
+    return offsets;
+}();
 
-    auto avg_light_opts = [](const std::array<std::optional<int>, 4>& arr) -> uint8_t {
-        int total = 0;
-        int count = 0;
-        for (const std::optional<int> i : arr) {
-            if (i.has_value()) {
-                total += *i;
-                count++;
-            }
-        }
-        const int val = count == 0 ? 0 : total / count;
-        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-        return static_cast<uint8_t>(nnm::clamp(val * 16, 0, 255));
-    };
+// Ring voxels touching each corner of a face as a mask over ring indices
+constexpr std::array<uint8_t, 4> sc_corner_ring_masks = [] {
+    std::array<uint8_t, 4> masks {};
+    for (int corner = 0; corner < 4; ++corner) {
+        masks[corner] = std::rotl(static_cast<uint8_t>(0b111), (corner * 2 + 7) % 8);
+    }
+    return masks;
+}();
 
-    std::array lighting
-        = { avg_light_opts(adj_light[0]),
-            avg_light_opts(adj_light[1]),
-            avg_light_opts(adj_light[2]),
-            avg_light_opts(adj_light[3]) };
-
-    for (int i = 0; i < check_blocks.size(); i++) {
-        const nnm::Vector3i check_block_local = local_block_pos + check_blocks[i];
-        std::optional<uint8_t> check_block;
-        if (is_block_pos_local(check_block_local)) {
-            check_block = chunk_data.get_block(check_block_local);
+// Number of solid ring voxels touching each corner for every mask of solid ring voxels
+constexpr std::array<std::array<uint8_t, 4>, 256> sc_corner_occluders = [] {
+    std::array<std::array<uint8_t, 4>, 256> occluders {};
+    for (int mask = 0; mask < 256; ++mask) {
+        for (int corner = 0; corner < 4; ++corner) {
+            const auto corner_mask = static_cast<uint8_t>(mask & sc_corner_ring_masks[corner]);
+            occluders[mask][corner] = static_cast<uint8_t>(std::popcount(corner_mask));
         }
-        else {
-            check_block = data.block_at_relative(chunk_pos, check_block_local);
+    }
+    return occluders;
+}();
+
+// Final corner lighting by number of occluders and averaged light level from 0 to 15. Each occluder darkens the corner
+// by a fixed factor with the result truncated every time.
+constexpr std::array<std::array<uint8_t, 16>, 4> sc_occluded_lighting = [] {
+    constexpr float occlusion_factor = 0.8f;
+    std::array<std::array<uint8_t, 16>, 4> table {};
+    for (int level = 0; level < 16; ++level) {
+        auto value = static_cast<uint8_t>(level * 16);
+        for (int occluders = 0; occluders < 4; ++occluders) {
+            table[occluders][level] = value;
+            value = static_cast<uint8_t>(static_cast<float>(value) * occlusion_factor);
         }
-        if (!check_block.has_value()) {
+    }
+    return table;
+}();
+
+std::array<uint8_t, 4> calc_chunk_face_lighting(
+    const ChunkNeighborhood& neighborhood, const nnm::Vector3i local_block_pos, const Direction dir)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    const FaceLightingOffsets& offsets = sc_face_lighting_offsets[static_cast<int>(dir)];
+    const int block_index = ChunkNeighborhood::index(local_block_pos);
+    const uint8_t base_lighting = neighborhood.lighting(block_index + offsets.facing);
+    VV_DEB_ASSERT(base_lighting <= 15, "[ChunkMesh] Base lighting is not between 0 and 15")
+
+    // Light is only taken from see-through voxels and occlusion only from solid ones, missing voxels are neither
+    std::array<uint8_t, 8> ring_lighting {};
+    uint32_t see_through_mask = 0;
+    uint32_t solid_mask = 0;
+    for (int i = 0; i < 8; ++i) {
+        const int index = block_index + offsets.ring[i];
+        const uint8_t block = neighborhood.block(index);
+        if (block == ChunkNeighborhood::sc_missing_block) {
             continue;
         }
-        constexpr float occlusion_factor = 0.8f;
-        static_assert(255 - static_cast<int>(occlusion_factor) * 3 > 0);
-        if (check_block.value() != 0) {
-            switch (i) {
-            case 0:
-                lighting[0] = static_cast<uint8_t>(static_cast<float>(lighting[0]) * occlusion_factor);
-                break;
-            case 1:
-                lighting[0] = static_cast<uint8_t>(static_cast<float>(lighting[0]) * occlusion_factor);
-                lighting[1] = static_cast<uint8_t>(static_cast<float>(lighting[1]) * occlusion_factor);
-                break;
-            case 2:
-                lighting[1] = static_cast<uint8_t>(static_cast<float>(lighting[1]) * occlusion_factor);
-                break;
-            case 3:
-                lighting[1] = static_cast<uint8_t>(static_cast<float>(lighting[1]) * occlusion_factor);
-                lighting[2] = static_cast<uint8_t>(static_cast<float>(lighting[2]) * occlusion_factor);
-                break;
-            case 4:
-                lighting[2] = static_cast<uint8_t>(static_cast<float>(lighting[2]) * occlusion_factor);
-                break;
-            case 5:
-                lighting[2] = static_cast<uint8_t>(static_cast<float>(lighting[2]) * occlusion_factor);
-                lighting[3] = static_cast<uint8_t>(static_cast<float>(lighting[3]) * occlusion_factor);
-                break;
-            case 6:
-                lighting[3] = static_cast<uint8_t>(static_cast<float>(lighting[3]) * occlusion_factor);
-                break;
-            case 7:
-                lighting[3] = static_cast<uint8_t>(static_cast<float>(lighting[3]) * occlusion_factor);
-                lighting[0] = static_cast<uint8_t>(static_cast<float>(lighting[0]) * occlusion_factor);
-                break;
-            default:
-                VV_REL_ASSERT(false, "Unreachable")
-            }
+        if (is_transparent(block)) {
+            ring_lighting[i] = neighborhood.lighting(index);
+            see_through_mask |= 1u << i;
+        }
+        if (block != 0) {
+            solid_mask |= 1u << i;
         }
     }
+
+    const std::array<uint8_t, 4>& occluders = sc_corner_occluders[solid_mask];
+    std::array<uint8_t, 4> lighting {};
+    for (int corner = 0; corner < 4; ++corner) {
+        const int total = base_lighting + ring_lighting[(corner * 2 + 7) % 8] + ring_lighting[corner * 2]
+            + ring_lighting[corner * 2 + 1];
+        const int count = 1 + std::popcount(see_through_mask & sc_corner_ring_masks[corner]);
+        lighting[corner] = sc_occluded_lighting[occluders[corner]][total / count];
+    }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     return lighting;
 }
 
+// Light of the voxel the face looks into on every corner, as calc_chunk_face_lighting would give with no occluders and
+// the same light all around
+std::array<uint8_t, 4> calc_chunk_face_flat_lighting(
+    const ChunkNeighborhood& neighborhood, const nnm::Vector3i local_block_pos, const Direction dir)
+{
+    const int facing_index
+        = ChunkNeighborhood::index(local_block_pos) + sc_face_lighting_offsets[static_cast<int>(dir)].facing;
+    const uint8_t lighting = sc_occluded_lighting[0][neighborhood.lighting(facing_index)];
+    return { lighting, lighting, lighting, lighting };
+}
+
 ChunkFaceData create_chunk_face_mesh(
-    const uint8_t block_type, const nnm::Vector3f offset, const Direction face, const std::array<uint8_t, 4>& lighting)
+    const uint8_t block_type,
+    const nnm::Vector3i local_pos,
+    const Direction face,
+    const std::array<uint8_t, 4>& lighting)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     ChunkFaceData data;
-    QuadUVs uvs;
+    const nnm::Vector2i tile = block_uv(block_type, face);
+    data.atlas_tile = static_cast<uint8_t>(tile.x + tile.y * sc_atlas_size.x);
+    data.face = face;
+    data.lighting = lighting;
+    data.is_translucent = is_transparent(block_type);
     switch (face) {
     case Direction::front:
-        uvs = uvs_from_atlas({ 4, 4 }, block_uv(block_type, Direction::front));
-        data.vertices[0] = nnm::Vector3(-0.5f, -0.5f, 0.5f) + offset;
-        data.vertices[1] = nnm::Vector3(0.5f, -0.5f, 0.5f) + offset;
-        data.vertices[2] = nnm::Vector3(0.5f, -0.5f, -0.5f) + offset;
-        data.vertices[3] = nnm::Vector3(-0.5f, -0.5f, -0.5f) + offset;
+        data.corners[0] = nnm::Vector3i(0, 0, 1) + local_pos;
+        data.corners[1] = nnm::Vector3i(1, 0, 1) + local_pos;
+        data.corners[2] = nnm::Vector3i(1, 0, 0) + local_pos;
+        data.corners[3] = nnm::Vector3i(0, 0, 0) + local_pos;
         break;
     case Direction::back:
-        uvs = uvs_from_atlas({ 4, 4 }, block_uv(block_type, Direction::back));
-        data.vertices[0] = nnm::Vector3(0.5f, 0.5f, 0.5f) + offset;
-        data.vertices[1] = nnm::Vector3(-0.5f, 0.5f, 0.5f) + offset;
-        data.vertices[2] = nnm::Vector3(-0.5f, 0.5f, -0.5f) + offset;
-        data.vertices[3] = nnm::Vector3(0.5f, 0.5f, -0.5f) + offset;
+        data.corners[0] = nnm::Vector3i(1, 1, 1) + local_pos;
+        data.corners[1] = nnm::Vector3i(0, 1, 1) + local_pos;
+        data.corners[2] = nnm::Vector3i(0, 1, 0) + local_pos;
+        data.corners[3] = nnm::Vector3i(1, 1, 0) + local_pos;
         break;
     case Direction::left:
-        uvs = uvs_from_atlas({ 4, 4 }, block_uv(block_type, Direction::left));
-        data.vertices[0] = nnm::Vector3(-0.5f, 0.5f, 0.5f) + offset;
-        data.vertices[1] = nnm::Vector3(-0.5f, -0.5f, 0.5f) + offset;
-        data.vertices[2] = nnm::Vector3(-0.5f, -0.5f, -0.5f) + offset;
-        data.vertices[3] = nnm::Vector3(-0.5f, 0.5f, -0.5f) + offset;
+        data.corners[0] = nnm::Vector3i(0, 1, 1) + local_pos;
+        data.corners[1] = nnm::Vector3i(0, 0, 1) + local_pos;
+        data.corners[2] = nnm::Vector3i(0, 0, 0) + local_pos;
+        data.corners[3] = nnm::Vector3i(0, 1, 0) + local_pos;
         break;
     case Direction::right:
-        uvs = uvs_from_atlas({ 4, 4 }, block_uv(block_type, Direction::right));
-        data.vertices[0] = nnm::Vector3(0.5f, -0.5f, 0.5f) + offset;
-        data.vertices[1] = nnm::Vector3(0.5f, 0.5f, 0.5f) + offset;
-        data.vertices[2] = nnm::Vector3(0.5f, 0.5f, -0.5f) + offset;
-        data.vertices[3] = nnm::Vector3(0.5f, -0.5f, -0.5f) + offset;
+        data.corners[0] = nnm::Vector3i(1, 0, 1) + local_pos;
+        data.corners[1] = nnm::Vector3i(1, 1, 1) + local_pos;
+        data.corners[2] = nnm::Vector3i(1, 1, 0) + local_pos;
+        data.corners[3] = nnm::Vector3i(1, 0, 0) + local_pos;
         break;
     case Direction::top:
-        uvs = uvs_from_atlas({ 4, 4 }, block_uv(block_type, Direction::top));
-        data.vertices[0] = nnm::Vector3(-0.5f, 0.5f, 0.5f) + offset;
-        data.vertices[1] = nnm::Vector3(0.5f, 0.5f, 0.5f) + offset;
-        data.vertices[2] = nnm::Vector3(0.5f, -0.5f, 0.5f) + offset;
-        data.vertices[3] = nnm::Vector3(-0.5f, -0.5f, 0.5f) + offset;
+        data.corners[0] = nnm::Vector3i(0, 1, 1) + local_pos;
+        data.corners[1] = nnm::Vector3i(1, 1, 1) + local_pos;
+        data.corners[2] = nnm::Vector3i(1, 0, 1) + local_pos;
+        data.corners[3] = nnm::Vector3i(0, 0, 1) + local_pos;
         break;
     case Direction::bottom:
-        uvs = uvs_from_atlas({ 4, 4 }, block_uv(block_type, Direction::bottom));
-        data.vertices[0] = nnm::Vector3(0.5f, 0.5f, -0.5f) + offset;
-        data.vertices[1] = nnm::Vector3(-0.5f, 0.5f, -0.5f) + offset;
-        data.vertices[2] = nnm::Vector3(-0.5f, -0.5f, -0.5f) + offset;
-        data.vertices[3] = nnm::Vector3(0.5f, -0.5f, -0.5f) + offset;
+        data.corners[0] = nnm::Vector3i(1, 1, 0) + local_pos;
+        data.corners[1] = nnm::Vector3i(0, 1, 0) + local_pos;
+        data.corners[2] = nnm::Vector3i(0, 0, 0) + local_pos;
+        data.corners[3] = nnm::Vector3i(1, 0, 0) + local_pos;
         break;
     default:
         VV_REL_ASSERT(false, "Unreachable")
     }
-    data.uvs[0] = uvs.top_left;
-    data.uvs[1] = uvs.top_right;
-    data.uvs[2] = uvs.bottom_right;
-    data.uvs[3] = uvs.bottom_left;
-    data.colors[0] = { static_cast<float>(lighting[0]) / 255.0f,
-                       static_cast<float>(lighting[0]) / 255.0f,
-                       static_cast<float>(lighting[0]) / 255.0f };
-    data.colors[1] = { static_cast<float>(lighting[1]) / 255.0f,
-                       static_cast<float>(lighting[1]) / 255.0f,
-                       static_cast<float>(lighting[1]) / 255.0f };
-    data.colors[2] = { static_cast<float>(lighting[2]) / 255.0f,
-                       static_cast<float>(lighting[2]) / 255.0f,
-                       static_cast<float>(lighting[2]) / 255.0f };
-    data.colors[3] = { static_cast<float>(lighting[3]) / 255.0f,
-                       static_cast<float>(lighting[3]) / 255.0f,
-                       static_cast<float>(lighting[3]) / 255.0f };
     data.indices = { 0, 3, 2, 0, 2, 1 };
     // data.indices = { 0, 2, 3, 0, 1, 2 };
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     return data;
 }
 
-void add_face_to_mesh(ChunkMeshData& data, const ChunkFaceData& face)
+void add_face_to_mesh(ChunkBufferData& data, const ChunkFaceData& face)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    const uint32_t indices_offset = data.vertices.size();
-    for (int i = 0; i < face.vertices.size(); i++) {
-        data.vertices.push_back(face.vertices[i]);
-        data.colors.push_back(face.colors[i]);
-        data.uvs.push_back(face.uvs[i]);
+    const auto indices_offset = static_cast<uint32_t>(data.vertex_data.vertex_count());
+    std::array<PackedChunkVertex, 4> vertices;
+    for (size_t i = 0; i < face.corners.size(); i++) {
+        vertices[i] = pack_chunk_vertex({ .x = static_cast<uint8_t>(face.corners[i].x),
+                                          .y = static_cast<uint8_t>(face.corners[i].y),
+                                          .z = static_cast<uint8_t>(face.corners[i].z),
+                                          .face = static_cast<uint8_t>(face.face),
+                                          .corner = static_cast<uint8_t>(i),
+                                          .atlas_tile = face.atlas_tile,
+                                          .light = face.lighting[i],
+                                          .quad_width = face.width,
+                                          .quad_height = face.height });
     }
+    data.vertex_data.append_vertices<PackedChunkVertex>(vertices);
 
+    std::vector<uint32_t>& index_data = face.is_translucent ? data.translucent_index_data : data.index_data;
     for (const unsigned int index : face.indices) {
-        data.indices.push_back(index + indices_offset);
+        index_data.push_back(index + indices_offset);
     }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
-void calc_chunk_block_faces(
-    const uint8_t block_type,
-    ChunkMeshData& mesh,
-    const WorldData& world_data,
-    const ChunkData& chunk_data,
-    const nnm::Vector3i chunk_pos,
-    const nnm::Vector3i local_pos,
-    const bool iterate_empty,
-    const std::array<bool, 6>& directions = { true, true, true, true, true, true })
+// Occupancy of a chunk and its apron as one bit per voxel. For each axis there is an 18-bit row for every line of
+// voxels along that axis, indexed by the two other padded coordinates: x rows by [z][y], y rows by [z][x] and z rows
+// by [y][x]. Bit i of a row is padded coordinate i along the axis. Coarser snapshots only fill the first
+// grid_size() + 2 rows and bits.
+struct ChunkFaceMasks {
+    using AxisRows = std::array<std::array<uint32_t, ChunkNeighborhood::sc_size>, ChunkNeighborhood::sc_size>;
+
+    // Blocks that can have faces, anything but air and missing chunks
+    std::array<AxisRows, 3> solid {};
+    // Blocks a face can be seen through, air, transparent blocks and missing chunks
+    std::array<AxisRows, 3> see_through {};
+};
+
+ChunkFaceMasks create_chunk_face_masks(const ChunkNeighborhood& neighborhood)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    for (int f = 0; f < 6; f++) {
-        if (!directions[f]) {
-            continue;
-        }
-        const auto dir = static_cast<Direction>(f);
-        const nnm::Vector3i adj_local_pos = local_pos + direction_vector(dir);
-        std::optional<uint8_t> adj_block;
-        if (is_block_pos_local(adj_local_pos)) {
-            adj_block = chunk_data.get_block(adj_local_pos);
-        }
-        else {
-            adj_block = world_data.block_at(block_local_to_world(chunk_pos, adj_local_pos));
+    ChunkFaceMasks masks;
+    const int padded_size = neighborhood.grid_size() + 2;
+    for (int z = 0; z < padded_size; ++z) {
+        for (int y = 0; y < padded_size; ++y) {
+            int index = ChunkNeighborhood::index(-1, y - 1, z - 1);
+            for (int x = 0; x < padded_size; ++x, ++index) {
+                const uint8_t block = neighborhood.block(index);
+                const bool missing = block == ChunkNeighborhood::sc_missing_block;
+                const auto solid = static_cast<uint32_t>(block != 0 && !missing);
+                const auto see_through = static_cast<uint32_t>(missing || is_transparent(block));
+                masks.solid[0][z][y] |= solid << x;
+                masks.solid[1][z][x] |= solid << y;
+                masks.solid[2][y][x] |= solid << z;
+                masks.see_through[0][z][y] |= see_through << x;
+                masks.see_through[1][z][x] |= see_through << y;
+                masks.see_through[2][y][x] |= see_through << z;
+            }
         }
-        uint8_t adj_block_type = 0;
-        if (adj_block.has_value()) {
-            adj_block_type = *adj_block;
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    return masks;
+}
+
+nnm::Vector3i face_local_pos(const int axis, const int layer, const int a, const int b)
+{
+    switch (axis) {
+    case 0:
+        return { layer, a, b };
+    case 1:
+        return { a, layer, b };
+    default:
+        return { a, b, layer };
+    }
+}
+
+// A face waiting to be merged in greedy mode. Only faces with the same light on all four corners are merged since a
+// merged quad interpolates its corner light across its whole surface.
+struct GreedyCell {
+    uint8_t block = 0;
+    uint8_t lighting = 0;
+    bool is_set = false;
+
+    bool operator==(const GreedyCell&) const = default;
+};
+
+// Faces of one slice of the chunk indexed by [b][a] as in ChunkFaceMasks
+using GreedyLayer = std::array<std::array<GreedyCell, 16>, 16>;
+
+void add_merged_face(
+    ChunkBufferData& mesh,
+    const uint8_t block,
+    const Direction dir,
+    const uint8_t lighting,
+    const nnm::Vector3i min_pos,
+    const nnm::Vector3i max_pos,
+    const int cell_size)
+{
+    ChunkFaceData face = create_chunk_face_mesh(block, { 0, 0, 0 }, dir, { lighting, lighting, lighting, lighting });
+    // Stretch the unit face so each corner sits on the corner of the first or last cell it covers, in blocks so the
+    // width and height below count blocks and textures keep tiling once per block
+    for (nnm::Vector3i& corner : face.corners) {
+        for (int c = 0; c < 3; ++c) {
+            corner[c] = (corner[c] == 0 ? min_pos[c] : max_pos[c] + 1) * cell_size;
         }
-        if (iterate_empty) {
-            if (adj_block_type != 0 && is_block_pos_local(adj_local_pos)) {
-                std::array<uint8_t, 4> face_lighting = calc_chunk_face_lighting(
-                    world_data, chunk_data, chunk_pos, adj_local_pos, opposite_direction(dir));
-                ChunkFaceData face = create_chunk_face_mesh(
-                    adj_block_type, nnm::Vector3f(adj_local_pos), opposite_direction(dir), face_lighting);
-                add_face_to_mesh(mesh, face);
+    }
+    face.width = static_cast<uint8_t>(face.corners[0].manhattan_distance(face.corners[1]));
+    face.height = static_cast<uint8_t>(face.corners[1].manhattan_distance(face.corners[2]));
+    add_face_to_mesh(mesh, face);
+}
+
+void merge_greedy_layer(
+    ChunkBufferData& mesh,
+    GreedyLayer& layer,
+    const Direction dir,
+    const int axis,
+    const int layer_index,
+    const int cell_size)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    const int cells = 16 / cell_size;
+    for (int b = 0; b < cells; ++b) {
+        for (int a = 0; a < cells; ++a) {
+            const GreedyCell cell = layer[b][a];
+            if (!cell.is_set) {
+                continue;
             }
-        }
-        else {
-            if (adj_block_type == 0 || is_transparent(adj_block_type)) {
-                std::array<uint8_t, 4> face_lighting
-                    = calc_chunk_face_lighting(world_data, chunk_data, chunk_pos, local_pos, dir);
-                ChunkFaceData face = create_chunk_face_mesh(block_type, nnm::Vector3f(local_pos), dir, face_lighting);
-                add_face_to_mesh(mesh, face);
+            int width = 1;
+            while (a + width < cells && layer[b][a + width] == cell) {
+                ++width;
+            }
+            auto row_matches = [&](const std::array<GreedyCell, 16>& row) {
+                return std::all_of(
+                    row.begin() + a, row.begin() + a + width, [&](const GreedyCell& other) { return other == cell; });
+            };
+            int height = 1;
+            while (b + height < cells && row_matches(layer[b + height])) {
+                ++height;
+            }
+            for (int y = b; y < b + height; ++y) {
+                std::fill_n(layer[y].begin() + a, width, GreedyCell {});
             }
+            add_merged_face(
+                mesh,
+                cell.block,
+                dir,
+                cell.lighting,
+                face_local_pos(axis, layer_index, a, b),
+                face_local_pos(axis, layer_index, a + width - 1, b + height - 1),
+                cell_size);
         }
     }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
-std::optional<ChunkBufferData> create_chunk_buffer_data(const nnm::Vector3i chunk_pos, const WorldData& world_data)
+// Finds every visible face a whole row at a time. A block has a face towards a neighbour if it is solid and the
+// neighbour is see-through, which is one shift and AND per row.
+void add_visible_faces(
+    ChunkBufferData& mesh, const ChunkNeighborhood& neighborhood, const ChunkFaceMasks& masks, const MeshingMode mode)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    ChunkMeshData mesh;
-    const ChunkData& chunk_data = world_data.chunk_data_at(chunk_pos);
-    for_3d({ 0, 0, 0 }, { 16, 16, 16 }, [&](const nnm::Vector3i local_pos) {
-        const uint8_t block = chunk_data.get_block(local_pos);
-        if (chunk_data.block_count() > 8 * 8 * 8) {
-            if (block != 0) {
-                std::array<bool, 6> directions {};
-                if (local_pos.x == 0) {
-                    directions[static_cast<size_t>(Direction::left)] = true;
-                }
-                if (local_pos.x == 15) {
-                    directions[static_cast<size_t>(Direction::right)] = true;
-                }
-                if (local_pos.y == 0) {
-                    directions[static_cast<size_t>(Direction::front)] = true;
-                }
-                if (local_pos.y == 15) {
-                    directions[static_cast<size_t>(Direction::back)] = true;
-                }
-                if (local_pos.z == 0) {
-                    directions[static_cast<size_t>(Direction::bottom)] = true;
-                }
-                if (local_pos.z == 15) {
-                    directions[static_cast<size_t>(Direction::top)] = true;
+    struct FaceDirection {
+        Direction dir;
+        int axis;
+        bool positive;
+    };
+    static constexpr std::array<FaceDirection, 6> sc_face_directions { { { Direction::left, 0, false },
+                                                                         { Direction::right, 0, true },
+                                                                         { Direction::front, 1, false },
+                                                                         { Direction::back, 1, true },
+                                                                         { Direction::bottom, 2, false },
+                                                                         { Direction::top, 2, true } } };
+    // Bits of the centre chunk, the apron is only ever looked at as a neighbour
+    const int cells = neighborhood.grid_size();
+    const uint32_t inner_bits = ((1u << cells) - 1) << 1;
+
+    std::array<GreedyLayer, 16> layers {};
+    // Merging leaves a layer empty again, so only layers that got a cell need it
+    std::array<bool, 16> used_layers {};
+    for (const auto [dir, axis, positive] : sc_face_directions) {
+        for (int b = 1; b <= cells; ++b) {
+            for (int a = 1; a <= cells; ++a) {
+                const uint32_t see_through = masks.see_through[axis][b][a];
+                uint32_t faces
+                    = masks.solid[axis][b][a] & (positive ? see_through >> 1 : see_through << 1) & inner_bits;
+                while (faces != 0) {
+                    const int bit = std::countr_zero(faces);
+                    faces &= faces - 1;
+                    const nnm::Vector3i local_pos = face_local_pos(axis, bit - 1, a - 1, b - 1);
+                    const uint8_t block = neighborhood.block(local_pos);
+                    const std::array<uint8_t, 4> face_lighting = mode == MeshingMode::lod
+                        ? calc_chunk_face_flat_lighting(neighborhood, local_pos, dir)
+                        : calc_chunk_face_lighting(neighborhood, local_pos, dir);
+                    if (mode != MeshingMode::naive
+                        && std::ranges::all_of(face_lighting, [&](const uint8_t l) { return l == face_lighting[0]; })) {
+                        layers[bit - 1][b - 1][a - 1]
+                            = GreedyCell { .block = block, .lighting = face_lighting[0], .is_set = true };
+                        used_layers[bit - 1] = true;
+                        continue;
+                    }
+                    add_face_to_mesh(mesh, create_chunk_face_mesh(block, local_pos, dir, face_lighting));
                 }
-                calc_chunk_block_faces(block, mesh, world_data, chunk_data, chunk_pos, local_pos, false, directions);
-            }
-            if (block == 0 || is_transparent(block)) {
-                calc_chunk_block_faces(block, mesh, world_data, chunk_data, chunk_pos, local_pos, true);
             }
         }
-        else {
-            if (block != 0) {
-                calc_chunk_block_faces(block, mesh, world_data, chunk_data, chunk_pos, local_pos, false);
+        if (mode != MeshingMode::naive) {
+            for (int layer = 0; layer < cells; ++layer) {
+                if (used_layers[layer]) {
+                    merge_greedy_layer(mesh, layers[layer], dir, axis, layer, neighborhood.cell_size());
+                    used_layers[layer] = false;
+                }
             }
         }
-    });
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
 
-    if (mesh.vertices.empty()) {
+std::optional<ChunkBufferData> create_chunk_buffer_data(
+    const nnm::Vector3i chunk_pos, const WorldData& world_data, ChunkMeshPool& pool, const MeshingMode mode)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    if (world_data.chunk_data_at(chunk_pos).block_count() == 0) {
         PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
         return {};
     }
 
-    mve::VertexData vertex_data(WorldRenderer::vertex_layout());
-    for (int i = 0; i < mesh.vertices.size(); i++) {
-        vertex_data.push_back(mesh.vertices.at(i) + nnm::Vector3f(chunk_pos) * 16.0f);
-        vertex_data.push_back(mesh.colors.at(i));
-        vertex_data.push_back(mesh.uvs.at(i));
-        vertex_data.push_back(1.0f);
+    std::optional<ChunkBufferData> buffer_data
+        = create_chunk_buffer_data(ChunkNeighborhood(world_data, chunk_pos), pool, mode);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    return buffer_data;
+}
+
+std::optional<ChunkBufferData> create_chunk_buffer_data(
+    const ChunkNeighborhood& neighborhood, ChunkMeshPool& pool, const MeshingMode mode)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    // Only merged faces are scaled from cells to blocks, and lod merges every face
+    VV_DEB_ASSERT(
+        neighborhood.level() == 0 || mode == MeshingMode::lod, "[ChunkMesh] Coarse snapshots need MeshingMode::lod")
+    // Faces are written straight into the reused storage of a pooled mesh
+    ChunkBufferData buffer_data = pool.acquire(neighborhood.chunk_pos());
+    add_visible_faces(buffer_data, neighborhood, create_chunk_face_masks(neighborhood), mode);
+    buffer_data.opaque_index_count = buffer_data.index_data.size();
+    buffer_data.index_data.insert(
+        buffer_data.index_data.end(),
+        buffer_data.translucent_index_data.begin(),
+        buffer_data.translucent_index_data.end());
+    buffer_data.translucent_index_data.clear();
+
+    if (buffer_data.index_data.empty()) {
+        pool.release(std::move(buffer_data));
+        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+        return {};
     }
-    return ChunkBufferData {
-        .chunk_pos = chunk_pos, .vertex_data = std::move(vertex_data), .index_data = std::move(mesh.indices)
-    };
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    return buffer_data;
 }
+
+void apply_chunk_lod(ChunkNeighborhood& neighborhood, const ChunkLod& lod)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    VV_DEB_ASSERT(neighborhood.level() == lod.level, "[ChunkMesh] Snapshot taken at another level of detail")
+    if (lod.skirt_sides != 0) {
+        // Two cells of the next coarser level deep, neighbours are at most one level apart and their surfaces rarely
+        // differ by more on anything but cliffs
+        neighborhood.add_skirts(lod.skirt_sides, 4);
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
\ No newline at end of file
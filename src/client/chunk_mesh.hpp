@@ -1,58 +1,88 @@
 #pragma once
 
 #include <array>
+#include <optional>
+#include <vector>
 
+#include "chunk_vertex.hpp"
 #include "common.hpp"
 
 #include <nnm/nnm.hpp>
 
-#include <mve/renderer.hpp>
+#include <mve/vertex_data.hpp>
 
+class ChunkMeshPool;
+class ChunkNeighborhood;
 class WorldData;
-struct ChunkFaceData {
-    std::array<nnm::Vector3f, 4> vertices;
-    std::array<nnm::Vector3f, 4> colors;
-    std::array<nnm::Vector2f, 4> uvs;
-    std::array<uint32_t, 6> indices {};
+
+// Size of the block texture atlas in tiles
+inline constexpr nnm::Vector2i sc_atlas_size { 4, 4 };
+
+enum class MeshingMode {
+    // One quad per visible block face
+    naive,
+    // Coplanar neighbouring faces with the same block type and uniform light are merged into larger quads
+    greedy,
+    // Greedy merging with flat lighting and no ambient occlusion so every face can merge, for distant chunks meshed
+    // from coarse cells where the smooth lighting could not be seen anyway
+    lod
+};
+
+// Level of detail a chunk is meshed at
+struct ChunkLod {
+    // Level 0 is full resolution, level n is meshed from cells of 2^n blocks along each axis, see ChunkNeighborhood
+    int level = 0;
+    // ChunkSideBits of the sides facing a chunk at another level, these get skirts
+    uint8_t skirt_sides = 0;
+
+    bool operator==(const ChunkLod&) const = default;
 };
 
-struct ChunkMeshData {
-    std::vector<nnm::Vector3f> vertices;
-    std::vector<nnm::Vector3f> colors;
-    std::vector<nnm::Vector2f> uvs;
-    std::vector<uint32_t> indices;
+inline constexpr int sc_max_lod_level = 3;
+
+struct ChunkFaceData {
+    // Chunk-local corner positions from 0 to 16
+    std::array<nnm::Vector3i, 4> corners;
+    std::array<uint8_t, 4> lighting {};
+    Direction face {};
+    uint8_t atlas_tile = 0;
+    // Size in blocks, only merged faces are larger than one block
+    uint8_t width = 1;
+    uint8_t height = 1;
+    std::array<uint32_t, 6> indices {};
+    bool is_translucent = false;
 };
 
 struct ChunkBufferData {
     nnm::Vector3i chunk_pos;
     mve::VertexData vertex_data;
+    // Indices of opaque faces followed by indices of translucent faces
     std::vector<uint32_t> index_data;
+    size_t opaque_index_count = 0;
+    // Translucent indices while meshing, appended to index_data once every face is added
+    std::vector<uint32_t> translucent_index_data {};
 };
 
-class ChunkBuffers {
-public:
-    ChunkBuffers(mve::Renderer& renderer, const ChunkBufferData& buffer_data)
-        : m_chunk_pos(buffer_data.chunk_pos)
-        , m_vertex_buffer(renderer.create_vertex_buffer(buffer_data.vertex_data))
-        , m_index_buffer(renderer.create_index_buffer(buffer_data.index_data))
-    {
-    }
-
-    [[nodiscard]] nnm::Vector3i chunk_pos() const
-    {
-        return m_chunk_pos;
-    }
-
-    void draw(mve::Renderer& renderer) const
-    {
-        renderer.bind_vertex_buffer(m_vertex_buffer);
-        renderer.draw_index_buffer(m_index_buffer);
-    }
-
-private:
-    nnm::Vector3i m_chunk_pos;
-    mve::VertexBuffer m_vertex_buffer;
-    mve::IndexBuffer m_index_buffer;
-};
+// Smooth lighting with ambient occlusion of the four corners of the face of a block in the centre chunk
+[[nodiscard]] std::array<uint8_t, 4> calc_chunk_face_lighting(
+    const ChunkNeighborhood& neighborhood, nnm::Vector3i local_block_pos, Direction dir);
+
+// Mesh storage is taken from pool and should be released back to it once uploaded
+std::optional<ChunkBufferData> create_chunk_buffer_data(
+    nnm::Vector3i chunk_pos,
+    const WorldData& world_data,
+    ChunkMeshPool& pool,
+    MeshingMode mode = MeshingMode::naive);
+
+// Meshes the centre chunk of a snapshot, does not touch WorldData so it can run while the world is being modified
+std::optional<ChunkBufferData> create_chunk_buffer_data(
+    const ChunkNeighborhood& neighborhood, ChunkMeshPool& pool, MeshingMode mode = MeshingMode::naive);
+
+// Adds skirts for lod to a snapshot taken at lod.level, the snapshot can then be meshed with lod_meshing_mode
+void apply_chunk_lod(ChunkNeighborhood& neighborhood, const ChunkLod& lod);
 
-std::optional<ChunkBufferData> create_chunk_buffer_data(nnm::Vector3i chunk_pos, const WorldData& world_data);
\ No newline at end of file
+// Full resolution chunks keep mode, coarser ones are meshed with MeshingMode::lod
+[[nodiscard]] inline MeshingMode lod_meshing_mode(const ChunkLod& lod, const MeshingMode mode)
+{
+    return lod.level > 0 ? MeshingMode::lod : mode;
+}
\ No newline at end of file
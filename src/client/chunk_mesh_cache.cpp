@@ -0,0 +1,148 @@
+#include "chunk_mesh_cache.hpp"
+
+#include <iterator>
+
+#include "chunk_mesh_pool.hpp"
+#include "chunk_neighborhood.hpp"
+#include <game_performance_profiler.hpp>
+
+ChunkMeshCache::ChunkMeshCache(const size_t max_memory)
+    : m_max_memory(max_memory)
+{
+}
+
+std::optional<ChunkBufferData> ChunkMeshCache::get_or_create(
+    const ChunkNeighborhood& neighborhood, ChunkMeshPool& pool, const MeshingMode mode)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    const uint64_t key = neighborhood.content_hash(static_cast<uint64_t>(mode));
+    {
+        std::scoped_lock lock(m_mutex);
+        if (const auto lookup = m_lookup.find(key); lookup != m_lookup.end()) {
+            ++m_hits;
+            m_entries.splice(m_entries.begin(), m_entries, lookup->second);
+            const Entry& entry = *lookup->second;
+            if (entry.indices.empty()) {
+                PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+                return {};
+            }
+            // Copied while locked since another worker may evict the entry as soon as the lock is released
+            ChunkBufferData data = pool.acquire(neighborhood.chunk_pos());
+            std::vector<std::byte> vertex_bytes = data.vertex_data.release();
+            vertex_bytes.assign(entry.vertex_bytes.begin(), entry.vertex_bytes.end());
+            data.vertex_data.adopt(std::move(vertex_bytes));
+            data.index_data.assign(entry.indices.begin(), entry.indices.end());
+            data.opaque_index_count = entry.opaque_index_count;
+            PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+            return data;
+        }
+        ++m_misses;
+    }
+
+    std::optional<ChunkBufferData> data = create_chunk_buffer_data(neighborhood, pool, mode);
+    // Empty meshes get a new entry, a recycled one would keep its vectors' capacity for nothing
+    EntryList node = data.has_value() ? acquire_entry() : EntryList(1);
+    Entry& entry = node.front();
+    entry.key = key;
+    if (data.has_value()) {
+        const std::span<const std::byte> vertex_bytes = data->vertex_data.bytes();
+        entry.vertex_bytes.assign(vertex_bytes.begin(), vertex_bytes.end());
+        entry.indices.assign(data->index_data.begin(), data->index_data.end());
+        entry.opaque_index_count = data->opaque_index_count;
+    }
+    insert(std::move(node));
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    return data;
+}
+
+void ChunkMeshCache::set_max_memory(const size_t max_memory)
+{
+    std::scoped_lock lock(m_mutex);
+    m_max_memory = max_memory;
+    evict_to(m_max_memory);
+}
+
+void ChunkMeshCache::clear()
+{
+    std::scoped_lock lock(m_mutex);
+    evict_to(0);
+    m_free_entries.clear();
+    m_free_lookup_nodes.clear();
+}
+
+ChunkMeshCache::Stats ChunkMeshCache::stats() const
+{
+    std::scoped_lock lock(m_mutex);
+    return { .hits = m_hits,
+             .misses = m_misses,
+             .entry_count = m_entries.size(),
+             .memory_usage = m_memory_usage,
+             .max_memory = m_max_memory };
+}
+
+size_t ChunkMeshCache::entry_memory(const Entry& entry)
+{
+    // A list node holds the entry and two pointers, a lookup node the key, an iterator and a next pointer
+    constexpr size_t node_overhead = 2 * sizeof(void*) + sizeof(uint64_t) + 2 * sizeof(void*);
+    return sizeof(Entry) + node_overhead + entry.vertex_bytes.capacity() + entry.indices.capacity() * sizeof(uint32_t);
+}
+
+ChunkMeshCache::EntryList ChunkMeshCache::acquire_entry()
+{
+    EntryList node;
+    std::scoped_lock lock(m_mutex);
+    if (m_free_entries.empty()) {
+        node.emplace_back();
+    }
+    else {
+        node.splice(node.begin(), m_free_entries, m_free_entries.begin());
+    }
+    return node;
+}
+
+void ChunkMeshCache::insert(EntryList node)
+{
+    const size_t memory = entry_memory(node.front());
+    std::scoped_lock lock(m_mutex);
+    // Another worker may have meshed the same content in the meantime
+    if (memory > m_max_memory || m_lookup.contains(node.front().key)) {
+        recycle(node, node.begin());
+        return;
+    }
+    evict_to(m_max_memory - memory);
+    m_entries.splice(m_entries.begin(), node);
+    if (m_free_lookup_nodes.empty()) {
+        m_lookup.emplace(m_entries.front().key, m_entries.begin());
+    }
+    else {
+        Lookup::node_type lookup_node = std::move(m_free_lookup_nodes.back());
+        m_free_lookup_nodes.pop_back();
+        lookup_node.key() = m_entries.front().key;
+        lookup_node.mapped() = m_entries.begin();
+        m_lookup.insert(std::move(lookup_node));
+    }
+    m_memory_usage += memory;
+}
+
+void ChunkMeshCache::evict_to(const size_t max_memory)
+{
+    while (m_memory_usage > max_memory) {
+        const auto last = std::prev(m_entries.end());
+        m_memory_usage -= entry_memory(*last);
+        if (Lookup::node_type lookup_node = m_lookup.extract(last->key);
+            m_free_lookup_nodes.size() < sc_max_free_entries) {
+            m_free_lookup_nodes.push_back(std::move(lookup_node));
+        }
+        recycle(m_entries, last);
+    }
+}
+
+void ChunkMeshCache::recycle(EntryList& from, const EntryList::iterator it)
+{
+    if (m_free_entries.size() < sc_max_free_entries) {
+        m_free_entries.splice(m_free_entries.begin(), from, it);
+    }
+    else {
+        from.erase(it);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk_mesh.hpp"
+
+class ChunkMeshPool;
+class ChunkNeighborhood;
+
+// LRU cache of chunk meshes keyed by a hash of everything meshing reads, the blocks and light of a ChunkNeighborhood
+// and the meshing mode. Meshes are chunk-local so a cached mesh is reused for any chunk with the same content just by
+// giving it that chunk's position, which covers columns that are culled and loaded again as well as repeated terrain.
+// Meshes without faces are cached too. Thread safe, mesh workers look up and insert concurrently.
+// Once the cache is full a miss refills the storage of an evicted entry, so its vectors are not allocated again.
+class ChunkMeshCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entry_count = 0;
+        size_t memory_usage = 0;
+        size_t max_memory = 0;
+    };
+
+    // Least recently used meshes are evicted once cached meshes take more than max_memory bytes, 0 disables caching
+    explicit ChunkMeshCache(size_t max_memory = 64 * 1024 * 1024);
+
+    ChunkMeshCache(const ChunkMeshCache&) = delete;
+    ChunkMeshCache& operator=(const ChunkMeshCache&) = delete;
+
+    // Same result as create_chunk_buffer_data, on a hit the cached mesh is copied into mesh data from pool instead of
+    // meshing
+    std::optional<ChunkBufferData> get_or_create(
+        const ChunkNeighborhood& neighborhood, ChunkMeshPool& pool, MeshingMode mode);
+
+    void set_max_memory(size_t max_memory);
+
+    void clear();
+
+    [[nodiscard]] Stats stats() const;
+
+private:
+    struct Entry {
+        uint64_t key;
+        std::vector<std::byte> vertex_bytes;
+        std::vector<uint32_t> indices;
+        size_t opaque_index_count;
+    };
+
+    using EntryList = std::list<Entry>;
+    using Lookup = std::unordered_map<uint64_t, EntryList::iterator>;
+
+    // Evicted entries and lookup nodes kept for reuse, enough for every mesh worker to miss at once
+    static constexpr size_t sc_max_free_entries = 16;
+
+    // Approximate heap usage of an entry including its list and lookup nodes
+    static size_t entry_memory(const Entry& entry);
+
+    // Single entry list holding an evicted entry to refill, whose vectors keep their capacity, or a new one
+    EntryList acquire_entry();
+
+    // Takes the entry in node, a single entry list
+    void insert(EntryList node);
+
+    // Expects m_mutex to be locked
+    void evict_to(size_t max_memory);
+
+    // Moves the entry at it out of from into the free list, expects m_mutex to be locked
+    void recycle(EntryList& from, EntryList::iterator it);
+
+    size_t m_max_memory;
+    mutable std::mutex m_mutex;
+    // Most recently used first
+    EntryList m_entries {};
+    Lookup m_lookup {};
+    EntryList m_free_entries {};
+    std::vector<Lookup::node_type> m_free_lookup_nodes {};
+    size_t m_memory_usage = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
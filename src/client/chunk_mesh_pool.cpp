@@ -0,0 +1,47 @@
+#include "chunk_mesh_pool.hpp"
+
+#include "chunk_vertex.hpp"
+
+ChunkMeshPool::ChunkMeshPool(const size_t max_free)
+    : m_max_free(max_free)
+{
+    m_free.reserve(max_free);
+}
+
+ChunkBufferData ChunkMeshPool::acquire(const nnm::Vector3i chunk_pos)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        if (!m_free.empty()) {
+            ChunkBufferData data = std::move(m_free.back());
+            m_free.pop_back();
+            data.chunk_pos = chunk_pos;
+            return data;
+        }
+    }
+    return { .chunk_pos = chunk_pos,
+             .vertex_data = mve::VertexData(mve::vertex_layout<PackedChunkVertex>()),
+             .index_data = {} };
+}
+
+void ChunkMeshPool::release(ChunkBufferData data)
+{
+    // Keep the capacity but not the contents
+    std::vector<std::byte> vertex_bytes = data.vertex_data.release();
+    vertex_bytes.clear();
+    data.vertex_data.adopt(std::move(vertex_bytes));
+    data.index_data.clear();
+    data.opaque_index_count = 0;
+    data.translucent_index_data.clear();
+
+    std::scoped_lock lock(m_mutex);
+    if (m_free.size() < m_max_free) {
+        m_free.push_back(std::move(data));
+    }
+}
+
+size_t ChunkMeshPool::free_count() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_free.size();
+}
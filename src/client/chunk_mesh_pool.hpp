@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <nnm/nnm.hpp>
+
+#include "chunk_mesh.hpp"
+
+// Recycles the storage of chunk meshes. Meshing takes a ChunkBufferData from the pool and writes into its existing
+// capacity, and once the mesh is uploaded the data is released back, so in steady state building a chunk mesh does not
+// touch the heap. Thread safe, mesh workers acquire while the main thread releases.
+class ChunkMeshPool {
+public:
+    // At most max_free meshes are kept for reuse, the rest are freed on release to bound memory
+    explicit ChunkMeshPool(size_t max_free = 128);
+
+    ChunkMeshPool(const ChunkMeshPool&) = delete;
+    ChunkMeshPool& operator=(const ChunkMeshPool&) = delete;
+
+    // Returns empty mesh data for chunk_pos, reusing the capacity of a released mesh if there is one
+    [[nodiscard]] ChunkBufferData acquire(nnm::Vector3i chunk_pos);
+
+    void release(ChunkBufferData data);
+
+    [[nodiscard]] size_t free_count() const;
+
+private:
+    size_t m_max_free;
+    mutable std::mutex m_mutex;
+    std::vector<ChunkBufferData> m_free {};
+};
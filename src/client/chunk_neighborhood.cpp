@@ -0,0 +1,223 @@
+#include "chunk_neighborhood.hpp"
+
+#include <cstdlib>
+
+#include "chunk_column.hpp"
+#include "common.hpp"
+#include "world_data.hpp"
+#include <game_performance_profiler.hpp>
+
+namespace {
+
+// Range of source voxels in a neighbouring chunk that fall inside the apron along one axis
+struct AxisRange {
+    int src_begin;
+    int src_end;
+};
+
+constexpr AxisRange axis_range(const int offset)
+{
+    switch (offset) {
+    case -1:
+        return { 15, 16 };
+    case 1:
+        return { 0, 1 };
+    default:
+        return { 0, 16 };
+    }
+}
+
+// Range of cells of a neighbouring chunk with cells per axis that fall inside the apron along one axis
+constexpr AxisRange cell_range(const int offset, const int cells)
+{
+    switch (offset) {
+    case -1:
+        return { cells - 1, cells };
+    case 1:
+        return { 0, 1 };
+    default:
+        return { 0, cells };
+    }
+}
+
+// Chunk of column at chunk_pos or null if the column is not loaded or the chunk is outside the world
+const ChunkData* find_chunk(const ChunkColumn* column, const nnm::Vector3i chunk_pos)
+{
+    return column != nullptr && chunk_pos.z >= -10 && chunk_pos.z < 10 ? &column->chunk_data_at(chunk_pos) : nullptr;
+}
+
+}
+
+ChunkNeighborhood::ChunkNeighborhood(const WorldData& world_data, const nnm::Vector3i chunk_pos, const int level)
+    : m_chunk_pos(chunk_pos)
+    , m_level(level)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    VV_DEB_ASSERT(level >= 0 && level <= 3, "[ChunkNeighborhood] Invalid level of detail")
+    if (level == 0) {
+        copy_blocks(world_data);
+    }
+    else {
+        copy_cells(world_data);
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void ChunkNeighborhood::copy_blocks(const WorldData& world_data)
+{
+    for (int oy = -1; oy <= 1; ++oy) {
+        for (int ox = -1; ox <= 1; ++ox) {
+            const ChunkColumn* column = world_data.find_column(nnm::Vector2i(m_chunk_pos.x + ox, m_chunk_pos.y + oy));
+            for (int oz = -1; oz <= 1; ++oz) {
+                const ChunkData* chunk = find_chunk(column, m_chunk_pos + nnm::Vector3i(ox, oy, oz));
+                const AxisRange rx = axis_range(ox);
+                const AxisRange ry = axis_range(oy);
+                const AxisRange rz = axis_range(oz);
+                const std::optional<uint8_t> uniform_block = chunk != nullptr ? chunk->uniform_block() : std::nullopt;
+                const std::optional<uint8_t> uniform_light
+                    = chunk != nullptr ? chunk->lighting().uniform() : std::optional<uint8_t>(0);
+                if (ox == 0 && oy == 0 && oz == 0) {
+                    m_is_uniform = uniform_block.has_value() && uniform_light.has_value();
+                }
+                for (int z = rz.src_begin; z < rz.src_end; ++z) {
+                    for (int y = ry.src_begin; y < ry.src_end; ++y) {
+                        const int dst_row = index(rx.src_begin + ox * 16, y + oy * 16, z + oz * 16);
+                        if (chunk == nullptr) {
+                            std::fill_n(m_blocks.begin() + dst_row, rx.src_end - rx.src_begin, sc_missing_block);
+                            std::fill_n(m_light.begin() + dst_row, rx.src_end - rx.src_begin, 0);
+                            continue;
+                        }
+                        for (int x = rx.src_begin; x < rx.src_end; ++x) {
+                            const size_t src = x + y * 16 + z * 16 * 16;
+                            const int dst = dst_row + (x - rx.src_begin);
+                            m_blocks[dst] = uniform_block.has_value() ? *uniform_block : chunk->blocks().get(src);
+                            m_light[dst] = uniform_light.has_value() ? *uniform_light : chunk->lighting().packed(src);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ChunkNeighborhood::copy_cells(const WorldData& world_data)
+{
+    // Voxels past the coarse grid and the edges and corners of the apron are never read by lod meshing, which has no
+    // smooth lighting, but are part of the content hash
+    m_blocks.fill(0);
+    m_light.fill(0);
+    const int cells = grid_size();
+    const int cell_size = 1 << m_level;
+    const int cell_volume = cell_size * cell_size * cell_size;
+    for (int oy = -1; oy <= 1; ++oy) {
+        for (int ox = -1; ox <= 1; ++ox) {
+            const ChunkColumn* column = world_data.find_column(nnm::Vector2i(m_chunk_pos.x + ox, m_chunk_pos.y + oy));
+            for (int oz = -1; oz <= 1; ++oz) {
+                if (std::abs(ox) + std::abs(oy) + std::abs(oz) > 1) {
+                    continue;
+                }
+                const ChunkData* chunk = find_chunk(column, m_chunk_pos + nnm::Vector3i(ox, oy, oz));
+                // The apron is the nearest cell of the neighbour, not its nearest block
+                const AxisRange rx = cell_range(ox, cells);
+                const AxisRange ry = cell_range(oy, cells);
+                const AxisRange rz = cell_range(oz, cells);
+                const std::optional<uint8_t> uniform_block = chunk != nullptr ? chunk->uniform_block() : std::nullopt;
+                const std::optional<uint8_t> uniform_light
+                    = chunk != nullptr ? chunk->lighting().uniform() : std::optional<uint8_t>(0);
+                if (ox == 0 && oy == 0 && oz == 0) {
+                    m_is_uniform = uniform_block.has_value() && uniform_light.has_value();
+                }
+                for (int cz = rz.src_begin; cz < rz.src_end; ++cz) {
+                    for (int cy = ry.src_begin; cy < ry.src_end; ++cy) {
+                        for (int cx = rx.src_begin; cx < rx.src_end; ++cx) {
+                            const int dst = index(cx + ox * cells, cy + oy * cells, cz + oz * cells);
+                            if (chunk == nullptr) {
+                                m_blocks[dst] = sc_missing_block;
+                                continue;
+                            }
+                            // Every cell of a uniform chunk holds what it would be downsampled to, which is most
+                            // chunks of a column
+                            if (uniform_block.has_value() && uniform_light.has_value()) {
+                                m_blocks[dst] = *uniform_block;
+                                m_light[dst] = *uniform_light;
+                                continue;
+                            }
+                            // A cell is solid if at least half of its blocks are and takes the type of its topmost
+                            // solid block so surfaces keep their top blocks, each light channel is the brightest in
+                            // the cell. Top down so the first solid block found is the topmost.
+                            int solid_count = 0;
+                            uint8_t top_block = 0;
+                            uint8_t sky = 0;
+                            uint8_t block_light = 0;
+                            for (int z = (cz + 1) * cell_size - 1; z >= cz * cell_size; --z) {
+                                for (int y = cy * cell_size; y < (cy + 1) * cell_size; ++y) {
+                                    for (int x = cx * cell_size; x < (cx + 1) * cell_size; ++x) {
+                                        const size_t src = x + y * 16 + z * 16 * 16;
+                                        const uint8_t block
+                                            = uniform_block.has_value() ? *uniform_block : chunk->blocks().get(src);
+                                        const uint8_t light = uniform_light.has_value()
+                                            ? *uniform_light
+                                            : chunk->lighting().packed(src);
+                                        if (block != 0) {
+                                            top_block = solid_count == 0 ? block : top_block;
+                                            ++solid_count;
+                                        }
+                                        sky = std::max<uint8_t>(sky, light & 0x0F);
+                                        block_light = std::max<uint8_t>(block_light, light >> 4);
+                                    }
+                                }
+                            }
+                            m_blocks[dst] = solid_count * 2 >= cell_volume ? top_block : 0;
+                            m_light[dst] = static_cast<uint8_t>(sky | block_light << 4);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ChunkNeighborhood::add_skirts(const uint8_t sides, const int depth)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    struct Side {
+        ChunkSideBits bit;
+        // Chunk voxel at the side for position a along the side
+        nnm::Vector3i edge_origin;
+        nnm::Vector3i along;
+        nnm::Vector3i outward;
+    };
+    const int last = grid_size() - 1;
+    const std::array<Side, 4> sides_info { { { side_neg_x, { 0, 0, 0 }, { 0, 1, 0 }, { -1, 0, 0 } },
+                                             { side_pos_x, { last, 0, 0 }, { 0, 1, 0 }, { 1, 0, 0 } },
+                                             { side_neg_y, { 0, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 } },
+                                             { side_pos_y, { 0, last, 0 }, { 1, 0, 0 }, { 0, 1, 0 } } } };
+    auto is_see_through = [&](const int i) { return m_blocks[i] != sc_missing_block && is_transparent(m_blocks[i]); };
+    for (const auto& [bit, edge_origin, along, outward] : sides_info) {
+        if ((sides & bit) == 0) {
+            continue;
+        }
+        for (int a = 0; a <= last; ++a) {
+            // Top down keeping the nearest see-through voxel above, the top of the apron counts as well
+            int open_index = -1;
+            int open_z = 0;
+            for (int z = last + 1; z >= 0; --z) {
+                const int i = index(edge_origin + along * a + nnm::Vector3i(0, 0, z));
+                if (is_see_through(i)) {
+                    open_index = i;
+                    open_z = z;
+                    continue;
+                }
+                if (z == last + 1 || open_index < 0 || open_z - z > depth) {
+                    continue;
+                }
+                if (const int apron = i + stride(outward);
+                    m_blocks[apron] != sc_missing_block && !is_see_through(apron)) {
+                    m_blocks[apron] = 0;
+                    m_light[apron] = m_light[open_index];
+                }
+            }
+        }
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
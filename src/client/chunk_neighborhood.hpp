@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include <nnm/nnm.hpp>
+
+#include "../common/assert.hpp"
+#include "../common/hash.hpp"
+
+class WorldData;
+
+// Vertical sides of a chunk as bits
+enum ChunkSideBits : uint8_t {
+    side_neg_x = 1 << 0,
+    side_pos_x = 1 << 1,
+    side_neg_y = 1 << 2,
+    side_pos_y = 1 << 3,
+};
+
+// Snapshot of a chunk's blocks and light plus a one voxel apron taken from its 26 neighbours, stored contiguously as
+// an 18^3 grid. Positions are local to the centre chunk so x, y and z range from -1 to 16 and kernels can look at any
+// neighbour of a chunk voxel without bounds checks or world lookups. Voxels of chunks that are not loaded or are
+// outside the world are sc_missing_block with no light.
+//
+// A snapshot at a coarser level of detail holds the same grid where each voxel is a cell of 2^level blocks along each
+// axis, so only the first grid_size() voxels along each axis belong to the centre chunk and the one after them is the
+// apron. The apron cells are taken from the six neighbours sharing a face the same way, so two neighbouring chunks at
+// the same level see exactly the cells the other one meshes.
+class ChunkNeighborhood {
+public:
+    static constexpr int sc_size = 18;
+    static constexpr int sc_volume = sc_size * sc_size * sc_size;
+    static constexpr uint8_t sc_missing_block = 0xFF;
+
+    ChunkNeighborhood(const WorldData& world_data, nnm::Vector3i chunk_pos, int level = 0);
+
+    [[nodiscard]] static constexpr int index(const int x, const int y, const int z)
+    {
+        return (x + 1) + (y + 1) * sc_size + (z + 1) * sc_size * sc_size;
+    }
+
+    [[nodiscard]] static constexpr int index(const nnm::Vector3i local_pos)
+    {
+        return index(local_pos.x, local_pos.y, local_pos.z);
+    }
+
+    // Index step to the neighbouring voxel along offset
+    [[nodiscard]] static constexpr int stride(const nnm::Vector3i offset)
+    {
+        return offset.x + offset.y * sc_size + offset.z * sc_size * sc_size;
+    }
+
+    [[nodiscard]] nnm::Vector3i chunk_pos() const
+    {
+        return m_chunk_pos;
+    }
+
+    [[nodiscard]] int level() const
+    {
+        return m_level;
+    }
+
+    // Blocks along each axis of one voxel
+    [[nodiscard]] int cell_size() const
+    {
+        return 1 << m_level;
+    }
+
+    // Voxels along each axis of the centre chunk
+    [[nodiscard]] int grid_size() const
+    {
+        return 16 >> m_level;
+    }
+
+    [[nodiscard]] uint8_t block(const int index) const
+    {
+        VV_DEB_ASSERT(index >= 0 && index < sc_volume, "[ChunkNeighborhood] Invalid index")
+        return m_blocks[index];
+    }
+
+    [[nodiscard]] uint8_t block(const nnm::Vector3i local_pos) const
+    {
+        return block(index(local_pos));
+    }
+
+    [[nodiscard]] bool is_missing(const int index) const
+    {
+        return block(index) == sc_missing_block;
+    }
+
+    // Sky light in the low nibble and block light in the high nibble, see LightStorage
+    [[nodiscard]] uint8_t packed_light(const int index) const
+    {
+        VV_DEB_ASSERT(index >= 0 && index < sc_volume, "[ChunkNeighborhood] Invalid index")
+        return m_light[index];
+    }
+
+    // Brightest of sky and block light
+    [[nodiscard]] uint8_t lighting(const int index) const
+    {
+        const uint8_t packed = packed_light(index);
+        return std::max<uint8_t>(packed & 0x0F, packed >> 4);
+    }
+
+    [[nodiscard]] uint8_t lighting(const nnm::Vector3i local_pos) const
+    {
+        return lighting(index(local_pos));
+    }
+
+    // Opens the apron on the given ChunkSideBits sides next to every chunk voxel that is within depth voxels below a
+    // see-through voxel, so the side faces of surfaces along those sides are always meshed. These skirts cover the
+    // cracks against a neighbour meshed at another level of detail whose surface is at a different height.
+    void add_skirts(uint8_t sides, int depth);
+
+    // Hash of every block and light value, snapshots with the same content produce the same chunk-local mesh wherever
+    // they are in the world
+    [[nodiscard]] uint64_t content_hash(const uint64_t seed = 0) const
+    {
+        const uint64_t level_seed = xxh64(std::as_bytes(std::span(&m_level, 1)), seed);
+        return xxh64(std::as_bytes(std::span(m_light)), xxh64(std::as_bytes(std::span(m_blocks)), level_seed));
+    }
+
+private:
+    void copy_blocks(const WorldData& world_data);
+    void copy_cells(const WorldData& world_data);
+
+    nnm::Vector3i m_chunk_pos;
+    int m_level;
+    std::array<uint8_t, sc_volume> m_blocks;
+    std::array<uint8_t, sc_volume> m_light;
+    // The centre chunk has one block type and one light value throughout
+    bool m_is_uniform = false;
+};
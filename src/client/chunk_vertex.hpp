@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <mve/vertex_data.hpp>
+
+// Unpacked attributes of a chunk mesh vertex
+struct ChunkVertex {
+    // Chunk-local corner position, the corner of a block is its position plus 0 or 1 on each axis so this is 0 to 16
+    uint8_t x = 0;
+    uint8_t y = 0;
+    uint8_t z = 0;
+    // Direction of the face
+    uint8_t face = 0;
+    // Corner of the face from 0 to 3, selects which corner of the quad the texture coordinates come from
+    uint8_t corner = 0;
+    // Block texture atlas tile from 0 to 15
+    uint8_t atlas_tile = 0;
+    // Lighting with ambient occlusion applied from 0 to 255
+    uint8_t light = 0;
+    // Size of the quad in blocks from 1 to 16, merged faces repeat their texture this many times
+    uint8_t quad_width = 1;
+    uint8_t quad_height = 1;
+
+    bool operator==(const ChunkVertex&) const = default;
+};
+
+// Chunk mesh vertex packed into two 32-bit words, the chunk offset comes from the per-chunk model matrix.
+// Must match the decode in simple.vert.
+//   data: x 5 | y 5 | z 5 | face 3 | corner 2 | atlas tile 4 | light 8
+//   quad: width 5 | height 5
+struct PackedChunkVertex {
+    uint32_t data = 0;
+    uint32_t quad = 0;
+
+    static constexpr std::array attributes {
+        mve::VertexAttributeType::uint, // Packed position, face, corner, atlas tile and light
+        mve::VertexAttributeType::uint // Packed quad size
+    };
+
+    bool operator==(const PackedChunkVertex&) const = default;
+};
+
+static_assert(sizeof(PackedChunkVertex) == 8);
+
+[[nodiscard]] constexpr PackedChunkVertex pack_chunk_vertex(const ChunkVertex& vertex)
+{
+    uint32_t data = vertex.x & 0x1Fu;
+    data |= (vertex.y & 0x1Fu) << 5;
+    data |= (vertex.z & 0x1Fu) << 10;
+    data |= (vertex.face & 0x7u) << 15;
+    data |= (vertex.corner & 0x3u) << 18;
+    data |= (vertex.atlas_tile & 0xFu) << 20;
+    data |= static_cast<uint32_t>(vertex.light) << 24;
+    const uint32_t quad = (vertex.quad_width & 0x1Fu) | (vertex.quad_height & 0x1Fu) << 5;
+    return { .data = data, .quad = quad };
+}
+
+[[nodiscard]] constexpr ChunkVertex unpack_chunk_vertex(const PackedChunkVertex packed)
+{
+    return { .x = static_cast<uint8_t>(packed.data & 0x1F),
+             .y = static_cast<uint8_t>(packed.data >> 5 & 0x1F),
+             .z = static_cast<uint8_t>(packed.data >> 10 & 0x1F),
+             .face = static_cast<uint8_t>(packed.data >> 15 & 0x7),
+             .corner = static_cast<uint8_t>(packed.data >> 18 & 0x3),
+             .atlas_tile = static_cast<uint8_t>(packed.data >> 20 & 0xF),
+             .light = static_cast<uint8_t>(packed.data >> 24),
+             .quad_width = static_cast<uint8_t>(packed.quad & 0x1F),
+             .quad_height = static_cast<uint8_t>(packed.quad >> 5 & 0x1F) };
+}
+
+// Round trips of every field at its extremes and of distinct values in every field, a change to the layout that loses
+// or overlaps bits fails to compile
+static_assert([] {
+    constexpr ChunkVertex min {};
+    constexpr ChunkVertex max { .x = 16,
+                                .y = 16,
+                                .z = 16,
+                                .face = 5,
+                                .corner = 3,
+                                .atlas_tile = 15,
+                                .light = 255,
+                                .quad_width = 16,
+                                .quad_height = 16 };
+    constexpr ChunkVertex mixed {
+        .x = 1, .y = 2, .z = 3, .face = 4, .corner = 1, .atlas_tile = 6, .light = 7, .quad_width = 8, .quad_height = 9
+    };
+    return unpack_chunk_vertex(pack_chunk_vertex(min)) == min && unpack_chunk_vertex(pack_chunk_vertex(max)) == max
+        && unpack_chunk_vertex(pack_chunk_vertex(mixed)) == mixed;
+}());
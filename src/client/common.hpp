@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <vector>
 
+#include "block_registry.hpp"
 #include "common.hpp"
 
 #include <game_performance_profiler.hpp>
@@ -345,18 +346,12 @@ inline nnm::Vector2i block_uv(const uint8_t block_type, const Direction face)
 
 inline bool is_transparent(const uint8_t block_type)
 {
-    switch (block_type) {
-    case 0:
-    case 9:
-        return true;
-    default:
-        return false;
-    }
+    return sc_block_properties[block_type].transparent;
 }
 
 inline bool is_emissive(const uint8_t block_type)
 {
-    return block_type == 10;
+    return light_emission(block_type) > 0;
 }
 
 inline nnm::Vector3i chunk_pos_from_block_pos(const nnm::Vector3i block_pos)
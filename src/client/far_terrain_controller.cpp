@@ -0,0 +1,150 @@
+#include "far_terrain_controller.hpp"
+
+#include <algorithm>
+
+#include "common.hpp"
+#include "world_generator.hpp"
+#include "world_renderer.hpp"
+#include <game_performance_profiler.hpp>
+
+FarTerrainController::FarTerrainController(const WorldGenerator& world_generator)
+    : m_world_generator(&world_generator)
+{
+}
+
+FarTerrainController::~FarTerrainController()
+{
+    // Jobs still running write to the completion queue which is destroyed before the thread pool
+    m_thread_pool.wait();
+}
+
+FarTerrainController& FarTerrainController::set_distances(const int inner, const int outer)
+{
+    m_inner_distance = inner;
+    m_outer_distance = outer;
+    // Forces the ring to be reevaluated on the next update
+    m_player_chunk_col = { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+    return *this;
+}
+
+void FarTerrainController::update(WorldRenderer& world_renderer, const nnm::Vector2i player_chunk_col)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    if (player_chunk_col != m_player_chunk_col) {
+        m_player_chunk_col = player_chunk_col;
+        on_player_chunk_change(world_renderer);
+    }
+    upload_completed_regions(world_renderer);
+    submit_region_jobs();
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void FarTerrainController::on_player_chunk_change(WorldRenderer& world_renderer)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    const auto inner_blocks = static_cast<float>(m_inner_distance * 16);
+    const auto outer_blocks = static_cast<float>(m_outer_distance * 16);
+    auto in_range = [&](const nnm::Vector2i region_pos, const float margin) {
+        return m_outer_distance > 0 && region_max_distance(region_pos) > inner_blocks - margin
+            && region_min_distance(region_pos) <= outer_blocks + margin;
+    };
+
+    // Meshes stay until a region is a whole region outside the ring so moving back and forth across its edge does not
+    // mesh the same regions again
+    std::vector<nnm::Vector2i> removed;
+    for (auto& [pos, flags] : m_region_flags) {
+        disable_flag(flags, flag_in_range);
+        if (!in_range(pos, static_cast<float>(sc_far_region_blocks))) {
+            removed.push_back(pos);
+        }
+    }
+    for (const nnm::Vector2i pos : removed) {
+        if (contains_flag(m_region_flags.at(pos), flag_has_mesh)) {
+            world_renderer.remove_far_region(pos);
+        }
+        // A job still in flight for the region is dropped when it completes
+        m_region_flags.erase(pos);
+    }
+
+    m_sorted_regions_in_range.clear();
+    const nnm::Vector2i min_region
+        = far_region_from_chunk_col(m_player_chunk_col - nnm::Vector2i::all(m_outer_distance));
+    const nnm::Vector2i max_region
+        = far_region_from_chunk_col(m_player_chunk_col + nnm::Vector2i::all(m_outer_distance));
+    for_2d(min_region, max_region + nnm::Vector2i(1, 1), [&](const nnm::Vector2i region_pos) {
+        if (in_range(region_pos, 0.0f)) {
+            enable_flag(m_region_flags[region_pos], flag_in_range);
+            m_sorted_regions_in_range.push_back(region_pos);
+        }
+    });
+    std::ranges::sort(m_sorted_regions_in_range, [&](const nnm::Vector2i a, const nnm::Vector2i b) {
+        return region_min_distance(a) < region_min_distance(b);
+    });
+    m_next_submit_index = 0;
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void FarTerrainController::upload_completed_regions(WorldRenderer& world_renderer)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    for (RegionJob* job = m_completed_region_jobs.pop_all(); job != nullptr; job = job->next) {
+        --m_region_jobs_in_flight;
+        if (uint8_t* flags = m_region_flags.find(job->region_pos);
+            flags != nullptr && contains_flag(*flags, flag_queued_mesh)) {
+            disable_flag(*flags, flag_queued_mesh);
+            world_renderer.push_far_region(job->result);
+            enable_flag(*flags, flag_has_mesh);
+        }
+        m_free_region_jobs.push_back(job);
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void FarTerrainController::submit_region_jobs()
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    // A few jobs at a time so regions near the player are meshed first when the ring changes
+    constexpr size_t max_in_flight = 4;
+    for (; m_next_submit_index < m_sorted_regions_in_range.size() && m_region_jobs_in_flight < max_in_flight;
+         ++m_next_submit_index) {
+        const nnm::Vector2i region_pos = m_sorted_regions_in_range[m_next_submit_index];
+        uint8_t& flags = m_region_flags.at(region_pos);
+        if (contains_flag(flags, flag_queued_mesh) || contains_flag(flags, flag_has_mesh)) {
+            continue;
+        }
+        enable_flag(flags, flag_queued_mesh);
+        RegionJob* job;
+        if (m_free_region_jobs.empty()) {
+            job = m_region_jobs.emplace_back(std::make_unique<RegionJob>()).get();
+        }
+        else {
+            job = m_free_region_jobs.back();
+            m_free_region_jobs.pop_back();
+        }
+        job->region_pos = region_pos;
+        ++m_region_jobs_in_flight;
+        m_thread_pool.detach_task([this, job] {
+            job->result = create_far_region_mesh(*m_world_generator, job->region_pos);
+            m_completed_region_jobs.push(job);
+        });
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+float FarTerrainController::region_min_distance(const nnm::Vector2i region_pos) const
+{
+    const nnm::Vector2f player = nnm::Vector2f(m_player_chunk_col * 16) + nnm::Vector2f::all(7.5f);
+    const nnm::Vector2f min = nnm::Vector2f(region_pos * sc_far_region_blocks);
+    const nnm::Vector2f max = min + nnm::Vector2f::all(static_cast<float>(sc_far_region_blocks - 1));
+    return player.clamp(min, max).distance(player);
+}
+
+float FarTerrainController::region_max_distance(const nnm::Vector2i region_pos) const
+{
+    const nnm::Vector2f player = nnm::Vector2f(m_player_chunk_col * 16) + nnm::Vector2f::all(7.5f);
+    const nnm::Vector2f min = nnm::Vector2f(region_pos * sc_far_region_blocks);
+    const nnm::Vector2f max = min + nnm::Vector2f::all(static_cast<float>(sc_far_region_blocks - 1));
+    const nnm::Vector2f furthest { nnm::abs(min.x - player.x) > nnm::abs(max.x - player.x) ? min.x : max.x,
+                                   nnm::abs(min.y - player.y) > nnm::abs(max.y - player.y) ? min.y : max.y };
+    return furthest.distance(player);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <BS_thread_pool.hpp>
+
+#include "chunk_map.hpp"
+#include "far_terrain_mesh.hpp"
+#include "mpsc_queue.hpp"
+
+#include <nnm/nnm.hpp>
+
+class WorldGenerator;
+class WorldRenderer;
+
+// Streams heightfield regions for the ring between the voxel render distance and the far terrain distance. Regions
+// are meshed from terrain heights alone on a background thread so the horizon goes several times further than the
+// voxel terrain without generating, lighting or storing any chunk columns for it.
+class FarTerrainController {
+public:
+    explicit FarTerrainController(const WorldGenerator& world_generator);
+
+    FarTerrainController(const FarTerrainController&) = delete;
+    FarTerrainController& operator=(const FarTerrainController&) = delete;
+
+    ~FarTerrainController();
+
+    // Regions entirely within inner columns of the player are covered by voxel terrain and skipped, regions reaching
+    // within outer columns are drawn. An outer distance of 0 disables far terrain.
+    FarTerrainController& set_distances(int inner, int outer);
+
+    void update(WorldRenderer& world_renderer, nnm::Vector2i player_chunk_col);
+
+    [[nodiscard]] int far_distance() const
+    {
+        return m_outer_distance;
+    }
+
+private:
+    enum RegionFlagBits {
+        flag_in_range = 1 << 0,
+        flag_queued_mesh = 1 << 1,
+        flag_has_mesh = 1 << 2,
+    };
+
+    template <typename T, typename U>
+    static bool contains_flag(T val, U flag)
+    {
+        return (val & flag) != 0;
+    }
+
+    template <typename T, typename U>
+    static void enable_flag(T& val, U flag)
+    {
+        val |= flag;
+    }
+
+    template <typename T, typename U>
+    static void disable_flag(T& val, U flag)
+    {
+        val &= ~flag;
+    }
+
+    // Meshing of one region on the background thread, reused once its result is handed to the renderer
+    struct RegionJob {
+        RegionJob* next = nullptr;
+        nnm::Vector2i region_pos;
+        FarRegionMeshData result;
+    };
+
+    void on_player_chunk_change(WorldRenderer& world_renderer);
+
+    void upload_completed_regions(WorldRenderer& world_renderer);
+
+    void submit_region_jobs();
+
+    // Distances in blocks from the player's column to the nearest and furthest block columns of a region
+    [[nodiscard]] float region_min_distance(nnm::Vector2i region_pos) const;
+
+    [[nodiscard]] float region_max_distance(nnm::Vector2i region_pos) const;
+
+    const WorldGenerator* m_world_generator;
+    // Regions are cheap to mesh so one thread keeps up without taking time from chunk meshing
+    BS::thread_pool m_thread_pool { 1 };
+    std::vector<std::unique_ptr<RegionJob>> m_region_jobs {};
+    std::vector<RegionJob*> m_free_region_jobs {};
+    MpscQueue<RegionJob> m_completed_region_jobs {};
+    size_t m_region_jobs_in_flight = 0;
+    ChunkMap<nnm::Vector2i, uint8_t> m_region_flags {};
+    // Regions in range nearest first
+    std::vector<nnm::Vector2i> m_sorted_regions_in_range {};
+    // Regions before this in m_sorted_regions_in_range are meshed or being meshed
+    size_t m_next_submit_index = 0;
+    nnm::Vector2i m_player_chunk_col = { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+    int m_inner_distance = 0;
+    int m_outer_distance = 0;
+};
@@ -0,0 +1,82 @@
+#include "far_terrain_mesh.hpp"
+
+#include "world_generator.hpp"
+#include <game_performance_profiler.hpp>
+
+// Mean colours of the grass top and grass side atlas tiles, steep slopes show mostly the sides of the voxel steps
+static constexpr nnm::Vector3f sc_far_grass_color { 0.027f, 0.464f, 0.0f };
+static constexpr nnm::Vector3f sc_far_slope_color { 0.361f, 0.271f, 0.05f };
+
+// Keeps the heightfield under the voxel surface it overlaps at the edge of the render distance
+static constexpr float sc_far_terrain_sink = 2.0f;
+
+FarRegionMeshData create_far_region_mesh(const WorldGenerator& world_generator, const nnm::Vector2i region_pos)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    // One extra sample on every side for the slopes along the region's edges
+    constexpr int grid_size = sc_far_region_samples + 2;
+    const nnm::Vector2i origin = region_pos * sc_far_region_blocks;
+    std::array<float, grid_size * grid_size> heights {};
+    for (int y = 0; y < grid_size; ++y) {
+        for (int x = 0; x < grid_size; ++x) {
+            const nnm::Vector2i block_pos = origin + nnm::Vector2i(x - 1, y - 1) * sc_far_sample_spacing;
+            // Top face of the highest solid block, blocks are centred on integer positions
+            heights[y * grid_size + x] = nnm::ceil(world_generator.terrain_height(block_pos)) - 0.5f;
+        }
+    }
+
+    FarRegionMeshData data { .region_pos = region_pos, .vertices = {}, .indices = {} };
+    data.vertices.reserve(sc_far_region_samples * sc_far_region_samples);
+    for (int y = 0; y < sc_far_region_samples; ++y) {
+        for (int x = 0; x < sc_far_region_samples; ++x) {
+            const int i = (y + 1) * grid_size + x + 1;
+            constexpr auto spacing = static_cast<float>(sc_far_sample_spacing);
+            const float slope_x = (heights[i + 1] - heights[i - 1]) / (2.0f * spacing);
+            const float slope_y = (heights[i + grid_size] - heights[i - grid_size]) / (2.0f * spacing);
+            const float normal_z = 1.0f / nnm::sqrt(1.0f + slope_x * slope_x + slope_y * slope_y);
+            const float steepness = nnm::clamp((1.0f - normal_z) * 4.0f, 0.0f, 1.0f);
+            data.vertices.push_back(
+                { .position = { static_cast<float>(x) * spacing,
+                                static_cast<float>(y) * spacing,
+                                heights[i] - sc_far_terrain_sink },
+                  .color = sc_far_grass_color + (sc_far_slope_color - sc_far_grass_color) * steepness });
+        }
+    }
+
+    data.indices.reserve((sc_far_region_samples - 1) * (sc_far_region_samples - 1) * 6);
+    for (int y = 0; y < sc_far_region_samples - 1; ++y) {
+        for (int x = 0; x < sc_far_region_samples - 1; ++x) {
+            const auto corner = static_cast<uint32_t>(y * sc_far_region_samples + x);
+            const uint32_t right = corner + 1;
+            const uint32_t up = corner + sc_far_region_samples;
+            const uint32_t up_right = up + 1;
+            // Counter-clockwise seen from above like the top faces of chunk meshes
+            data.indices.insert(data.indices.end(), { corner, right, up_right, corner, up_right, up });
+        }
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    return data;
+}
+
+FarRegionBuffers::FarRegionBuffers(
+    mve::Renderer& renderer,
+    mve::GraphicsPipeline& pipeline,
+    const mve::ShaderDescriptorSet& set,
+    const mve::ShaderDescriptorBinding& uniform_buffer_binding,
+    const FarRegionMeshData& mesh_data)
+    : m_descriptor_set(pipeline.create_descriptor_set(set))
+    , m_uniform_buffer(renderer.create_uniform_buffer(uniform_buffer_binding))
+    , m_vertex_buffer(renderer.create_vertex_buffer([&] {
+        mve::VertexData vertex_data(mve::vertex_layout<FarTerrainVertex>());
+        vertex_data.append_vertices<FarTerrainVertex>(mesh_data.vertices);
+        return vertex_data;
+    }()))
+    , m_index_buffer(renderer.create_index_buffer(mesh_data.indices))
+{
+    m_descriptor_set.write_binding(uniform_buffer_binding, m_uniform_buffer);
+    m_uniform_buffer.update(
+        uniform_buffer_binding.member("model").location(),
+        nnm::Transform3f().translate(nnm::Vector3f(nnm::Vector2f(mesh_data.region_pos * sc_far_region_blocks), 0.0f))
+            .matrix);
+    m_uniform_buffer.update(uniform_buffer_binding.member("fog_influence").location(), 1.0f);
+}
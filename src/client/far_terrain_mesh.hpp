@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <nnm/nnm.hpp>
+
+#include <mve/renderer.hpp>
+
+class WorldGenerator;
+
+// A far terrain region is a square of chunk columns drawn as one coarse heightfield
+inline constexpr int sc_far_region_columns = 8;
+inline constexpr int sc_far_region_blocks = sc_far_region_columns * 16;
+// Blocks between heightfield samples along each axis
+inline constexpr int sc_far_sample_spacing = 8;
+inline constexpr int sc_far_region_samples = sc_far_region_blocks / sc_far_sample_spacing + 1;
+
+// Vertex of the untextured color pipeline
+struct FarTerrainVertex {
+    nnm::Vector3f position;
+    nnm::Vector3f color;
+
+    static constexpr std::array attributes {
+        mve::VertexAttributeType::vec3, // Position
+        mve::VertexAttributeType::vec3 // Color
+    };
+};
+
+struct FarRegionMeshData {
+    nnm::Vector2i region_pos;
+    // Region-local positions, the region's first block column is at the origin
+    std::vector<FarTerrainVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+[[nodiscard]] inline nnm::Vector2i far_region_from_chunk_col(const nnm::Vector2i chunk_col)
+{
+    constexpr auto region_columns = static_cast<float>(sc_far_region_columns);
+    return { static_cast<int>(nnm::floor(static_cast<float>(chunk_col.x) / region_columns)),
+             static_cast<int>(nnm::floor(static_cast<float>(chunk_col.y) / region_columns)) };
+}
+
+// Heightfield of the terrain surface over the region sampled straight from WorldGenerator::terrain_height, so no
+// chunk data is generated. The surface is sunk slightly so voxel terrain covers it wherever both are drawn. Only reads
+// the generator so it can run on any thread.
+FarRegionMeshData create_far_region_mesh(const WorldGenerator& world_generator, nnm::Vector2i region_pos);
+
+class FarRegionBuffers {
+public:
+    FarRegionBuffers(
+        mve::Renderer& renderer,
+        mve::GraphicsPipeline& pipeline,
+        const mve::ShaderDescriptorSet& set,
+        const mve::ShaderDescriptorBinding& uniform_buffer_binding,
+        const FarRegionMeshData& mesh_data);
+
+    void draw(mve::Renderer& renderer, const mve::DescriptorSet& global_set) const
+    {
+        renderer.bind_descriptor_sets(global_set, m_descriptor_set);
+        renderer.bind_vertex_buffer(m_vertex_buffer);
+        renderer.draw_index_buffer(m_index_buffer);
+    }
+
+private:
+    mve::DescriptorSet m_descriptor_set;
+    mve::UniformBuffer m_uniform_buffer;
+    mve::VertexBuffer m_vertex_buffer;
+    mve::IndexBuffer m_index_buffer;
+};
@@ -0,0 +1,222 @@
+#include "light_engine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <tuple>
+
+#include "chunk_data.hpp"
+#include "common.hpp"
+#include "world_data.hpp"
+#include <game_performance_profiler.hpp>
+
+namespace {
+
+constexpr std::array<nnm::Vector3i, 6> c_adjacent {
+    { { 0, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 }, { 0, -1, 0 }, { 1, 0, 0 }, { -1, 0, 0 } }
+};
+
+// Sunlight enters the world above this height
+constexpr int c_top_block_height = 10 * 16 - 1;
+
+struct Voxel {
+    // nullptr outside of the loaded world
+    ChunkData* chunk;
+    nnm::Vector3i block_pos;
+    nnm::Vector3i local_pos;
+
+    // Voxels outside of the loaded world block light
+    [[nodiscard]] uint8_t opacity() const
+    {
+        return chunk != nullptr ? light_opacity(chunk->get_block(local_pos)) : 15;
+    }
+
+    [[nodiscard]] uint8_t block() const
+    {
+        return chunk->get_block(local_pos);
+    }
+
+    [[nodiscard]] uint8_t light(const LightChannel channel) const
+    {
+        return chunk->light_at(channel, local_pos);
+    }
+
+    [[nodiscard]] uint8_t packed_light() const
+    {
+        return static_cast<uint8_t>(light(LightChannel::sky) | light(LightChannel::block) << 4);
+    }
+};
+
+// Finds the chunks of voxels, the passes mostly step between neighbouring voxels so the last chunk is remembered
+class VoxelLookup {
+public:
+    explicit VoxelLookup(WorldData& world_data)
+        : m_world_data(&world_data)
+    {
+    }
+
+    Voxel voxel(const nnm::Vector3i block_pos)
+    {
+        const nnm::Vector3i chunk_pos { block_pos.x >> 4, block_pos.y >> 4, block_pos.z >> 4 };
+        if (chunk_pos != m_last_chunk_pos) {
+            m_last_chunk_pos = chunk_pos;
+            m_last_chunk = m_world_data->contains_chunk(chunk_pos) ? &m_world_data->chunk_data_at(chunk_pos) : nullptr;
+        }
+        return { m_last_chunk, block_pos, { block_pos.x & 15, block_pos.y & 15, block_pos.z & 15 } };
+    }
+
+private:
+    WorldData* m_world_data;
+    nnm::Vector3i m_last_chunk_pos { std::numeric_limits<int>::max(), 0, 0 };
+    ChunkData* m_last_chunk = nullptr;
+};
+
+}
+
+void LightEngine::update_block(WorldData& world_data, const nnm::Vector3i block_pos, const uint8_t old_block)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    VV_DEB_ASSERT(world_data.contains_chunk(chunk_pos_from_block_pos(block_pos)),
+                  "[LightEngine] Block outside of the loaded world")
+    const uint8_t new_block = world_data.chunk_data_at(chunk_pos_from_block_pos(block_pos))
+                                  .get_block(block_world_to_local(block_pos));
+    m_write_count = 0;
+    m_light_changes.clear();
+    // Sky light only depends on where light can pass, block light also on what gives it off
+    const bool opacity_changed = light_opacity(old_block) != light_opacity(new_block);
+    if (opacity_changed) {
+        update_channel(world_data, LightChannel::sky, block_pos, old_block);
+    }
+    if (opacity_changed || light_emission(old_block) != light_emission(new_block)) {
+        update_channel(world_data, LightChannel::block, block_pos, old_block);
+    }
+
+    // Every write was recorded with the light from before it, only the first write of a voxel has the light from
+    // before the update
+    std::ranges::stable_sort(m_light_changes, [](const LightChange& a, const LightChange& b) {
+        const nnm::Vector3i chunk_a = chunk_pos_from_block_pos(a.block_pos);
+        const nnm::Vector3i chunk_b = chunk_pos_from_block_pos(b.block_pos);
+        if (chunk_a != chunk_b) {
+            return std::tie(chunk_a.x, chunk_a.y, chunk_a.z) < std::tie(chunk_b.x, chunk_b.y, chunk_b.z);
+        }
+        return std::tie(a.block_pos.x, a.block_pos.y, a.block_pos.z)
+            < std::tie(b.block_pos.x, b.block_pos.y, b.block_pos.z);
+    });
+    const auto [first, last] = std::ranges::unique(m_light_changes, {}, &LightChange::block_pos);
+    m_light_changes.erase(first, last);
+    VoxelLookup lookup(world_data);
+    std::erase_if(m_light_changes, [&](const LightChange& change) {
+        const Voxel voxel = lookup.voxel(change.block_pos);
+        return voxel.packed_light() == change.packed_light_before;
+    });
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void LightEngine::update_channel(
+    WorldData& world_data, const LightChannel channel, const nnm::Vector3i block_pos, const uint8_t old_block)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    VoxelLookup lookup(world_data);
+    const Voxel edited = lookup.voxel(block_pos);
+    const uint8_t new_block = edited.block();
+    m_removal_queue.clear();
+    m_add_queue.clear();
+
+    auto set_light = [&](const Voxel& voxel, const uint8_t light) {
+        m_light_changes.push_back({ voxel.block_pos, voxel.packed_light() });
+        voxel.chunk->set_light(channel, voxel.local_pos, light);
+        ++m_write_count;
+    };
+    // Only block light has sources other than the sky
+    auto emission = [&](const uint8_t block) -> uint8_t {
+        return channel == LightChannel::block ? light_emission(block) : 0;
+    };
+
+    // Everything the old block lit is cleared, the new block is lit by the add pass like any other cleared voxel
+    const uint8_t light = edited.light(channel);
+    if (channel == LightChannel::sky && light == 15 && light_opacity(old_block) == 0 && light_opacity(new_block) != 0) {
+        // Sunlit voxels straight below are now in shadow
+        for (nnm::Vector3i pos = block_pos - nnm::Vector3i(0, 0, 1);; --pos.z) {
+            const Voxel voxel = lookup.voxel(pos);
+            if (voxel.opacity() != 0 || voxel.light(channel) != 15) {
+                break;
+            }
+            set_light(voxel, 0);
+            m_removal_queue.push_back({ pos, 15 });
+        }
+    }
+    if (light > 0) {
+        set_light(edited, 0);
+        m_removal_queue.push_back({ block_pos, light });
+    }
+
+    // A neighbour darker than the light being removed may have been lit by it and is cleared too, unless the
+    // neighbour gives off that light itself. Neighbours still lit afterwards have their own source and relight the
+    // cleared voxels.
+    for (size_t i = 0; i < m_removal_queue.size(); ++i) {
+        const auto [pos, removed_light] = m_removal_queue[i];
+        for (const nnm::Vector3i offset : c_adjacent) {
+            const nnm::Vector3i adj_pos = pos + offset;
+            const Voxel adj = lookup.voxel(adj_pos);
+            if (adj.opacity() == 15 && (adj.chunk == nullptr || emission(adj.block()) == 0)) {
+                continue;
+            }
+            const uint8_t adj_light = adj.light(channel);
+            if (const uint8_t adj_emission = emission(adj.block());
+                adj_light > adj_emission && adj_light < removed_light) {
+                set_light(adj, 0);
+                m_removal_queue.push_back({ adj_pos, adj_light });
+                if (adj_emission > 0) {
+                    m_add_queue.push_back(adj_pos);
+                }
+            }
+            else if (adj_light != 0) {
+                m_add_queue.push_back(adj_pos);
+            }
+        }
+    }
+
+    if (channel == LightChannel::sky && light_opacity(new_block) == 0) {
+        const Voxel above = lookup.voxel(block_pos + nnm::Vector3i(0, 0, 1));
+        if (block_pos.z == c_top_block_height || (above.opacity() == 0 && above.light(channel) == 15)) {
+            // Sunlight reaches down to the next block it cannot pass straight through
+            for (nnm::Vector3i pos = block_pos;; --pos.z) {
+                const Voxel voxel = lookup.voxel(pos);
+                if (voxel.opacity() != 0 || (pos != block_pos && voxel.light(channel) == 15)) {
+                    break;
+                }
+                set_light(voxel, 15);
+                m_add_queue.push_back(pos);
+            }
+        }
+    }
+    m_add_queue.push_back(block_pos);
+    if (lets_light_through(new_block)) {
+        for (const nnm::Vector3i offset : c_adjacent) {
+            if (lookup.voxel(block_pos + offset).chunk != nullptr) {
+                m_add_queue.push_back(block_pos + offset);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_add_queue.size(); ++i) {
+        const nnm::Vector3i pos = m_add_queue[i];
+        const Voxel voxel = lookup.voxel(pos);
+        uint8_t spread = voxel.light(channel);
+        if (const uint8_t voxel_emission = emission(voxel.block()); voxel_emission > spread) {
+            set_light(voxel, voxel_emission);
+            spread = voxel_emission;
+        }
+        for (const nnm::Vector3i offset : c_adjacent) {
+            const nnm::Vector3i adj_pos = pos + offset;
+            const Voxel adj = lookup.voxel(adj_pos);
+            if (const uint8_t opacity = adj.opacity(); opacity < 15 && spread > 1 + opacity) {
+                if (const auto adj_light = static_cast<uint8_t>(spread - 1 - opacity); adj.light(channel) < adj_light) {
+                    set_light(adj, adj_light);
+                    m_add_queue.push_back(adj_pos);
+                }
+            }
+        }
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
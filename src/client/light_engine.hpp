@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <nnm/nnm.hpp>
+
+#include "light_storage.hpp"
+
+class WorldData;
+
+// Keeps sky and block light settled across block edits by only relighting the voxels around the edit whose light can
+// change instead of relighting the surrounding chunks from scratch. Light the edit takes away is cleared by a
+// breadth-first removal pass, which queues the lit voxels bordering the cleared region and the emissive blocks inside
+// it, and an add pass spreads light from those and from any new light back into it. The result is the same as lighting
+// the world with apply_sunlight, propagate_light and propagate_block_light as long as the light around the edit was
+// settled beforehand. In the game ChunkController settles columns with LightScheduler::light_new_columns as they are
+// generated or loaded, before they can be meshed or edited. Light written any other way, like apply_sunlight alone,
+// has to be settled with relight_columns first.
+class LightEngine {
+public:
+    // A voxel whose light the last update changed
+    struct LightChange {
+        nnm::Vector3i block_pos;
+        // Sky light in the low four bits and block light in the high four, as LightStorage packs it
+        uint8_t packed_light_before;
+    };
+
+    // Call after the block at block_pos was changed from old_block to what world_data holds now
+    void update_block(WorldData& world_data, nnm::Vector3i block_pos, uint8_t old_block);
+
+    // Voxels whose light was written by the last update, including ones cleared and relit to the same value
+    [[nodiscard]] size_t last_update_write_count() const
+    {
+        return m_write_count;
+    }
+
+    // Voxels whose light differs after the last update, each once and grouped by chunk. Voxels that were cleared and
+    // relit to the light they had are left out.
+    [[nodiscard]] std::span<const LightChange> last_update_light_changes() const
+    {
+        return m_light_changes;
+    }
+
+private:
+    void update_channel(WorldData& world_data, LightChannel channel, nnm::Vector3i block_pos, uint8_t old_block);
+
+    struct RemovalNode {
+        nnm::Vector3i pos;
+        // Light the voxel spread before it was cleared
+        uint8_t light;
+    };
+
+    std::vector<RemovalNode> m_removal_queue {};
+    std::vector<nnm::Vector3i> m_add_queue {};
+    size_t m_write_count = 0;
+    std::vector<LightChange> m_light_changes {};
+};
@@ -0,0 +1,100 @@
+#include "light_scheduler.hpp"
+
+#include <algorithm>
+
+#include "lighting.hpp"
+#include "world_data.hpp"
+#include <game_performance_profiler.hpp>
+
+namespace {
+
+// Light spreading out of a column reaches the next column, the 2x2 tiles of one colour are two columns apart so the
+// columns they write to never overlap
+nnm::Vector2i tile_of(const nnm::Vector2i column_pos)
+{
+    return { column_pos.x >> 1, column_pos.y >> 1 };
+}
+
+int tile_color(const nnm::Vector2i tile_pos)
+{
+    return (tile_pos.x & 1) | (tile_pos.y & 1) << 1;
+}
+
+}
+
+LightScheduler::LightScheduler(BS::thread_pool& thread_pool)
+    : m_thread_pool(&thread_pool)
+{
+}
+
+void LightScheduler::relight_columns(WorldData& world_data, const std::span<const nnm::Vector2i> columns)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    m_sorted_columns.assign(columns.begin(), columns.end());
+    light_columns(world_data, columns);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void LightScheduler::light_new_columns(WorldData& world_data, const std::span<const nnm::Vector2i> columns)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    m_sorted_columns.clear();
+    for (const nnm::Vector2i col : columns) {
+        for_2d({ -1, -1 }, { 2, 2 }, [&](const nnm::Vector2i offset) {
+            const nnm::Vector2i neighbor = col + offset;
+            if (!world_data.contains_column(neighbor)) {
+                return;
+            }
+            // Columns that are only loaded or queued for trees have no light of their own yet
+            if (world_data.chunk_column_data_at(neighbor).gen_level() == ChunkColumn::generated
+                || std::ranges::find(columns, neighbor) != columns.end()) {
+                m_sorted_columns.push_back(neighbor);
+            }
+        });
+    }
+    std::ranges::sort(m_sorted_columns, [](const nnm::Vector2i a, const nnm::Vector2i b) {
+        return a.y < b.y || (a.y == b.y && a.x < b.x);
+    });
+    const auto [first, last] = std::ranges::unique(m_sorted_columns);
+    m_sorted_columns.erase(first, last);
+    light_columns(world_data, columns);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void LightScheduler::light_columns(WorldData& world_data, const std::span<const nnm::Vector2i> reset_columns)
+{
+    BS::multi_future<void> reset_tasks
+        = m_thread_pool->submit_loop(size_t { 0 }, reset_columns.size(), [&](const size_t i) {
+              reset_column_light(world_data.chunk_column_data_at(reset_columns[i]));
+          });
+
+    std::ranges::sort(m_sorted_columns, [](const nnm::Vector2i a, const nnm::Vector2i b) {
+        const nnm::Vector2i tile_a = tile_of(a);
+        const nnm::Vector2i tile_b = tile_of(b);
+        if (tile_color(tile_a) != tile_color(tile_b)) {
+            return tile_color(tile_a) < tile_color(tile_b);
+        }
+        return tile_a.y < tile_b.y || (tile_a.y == tile_b.y && tile_a.x < tile_b.x);
+    });
+    reset_tasks.wait();
+
+    for (size_t begin = 0; begin < m_sorted_columns.size();) {
+        // Every tile of one colour is queued before waiting for them
+        const int color = tile_color(tile_of(m_sorted_columns[begin]));
+        while (begin < m_sorted_columns.size() && tile_color(tile_of(m_sorted_columns[begin])) == color) {
+            const nnm::Vector2i tile = tile_of(m_sorted_columns[begin]);
+            size_t end = begin + 1;
+            while (end < m_sorted_columns.size() && tile_of(m_sorted_columns[end]) == tile) {
+                ++end;
+            }
+            m_tasks.push_back(m_thread_pool->submit_task([this, &world_data, begin, end] {
+                for (size_t i = begin; i < end; ++i) {
+                    propagate_column_light(world_data, m_sorted_columns[i]);
+                }
+            }));
+            begin = end;
+        }
+        m_tasks.wait();
+        m_tasks.clear();
+    }
+}
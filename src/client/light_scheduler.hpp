@@ -0,0 +1,43 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <BS_thread_pool.hpp>
+#include <nnm/nnm.hpp>
+
+class WorldData;
+
+// Lights whole columns from scratch on a thread pool with the same result as relight_columns. Sunlight stays within its
+// column so every column gets it in parallel first. Spreading light out of a column also writes to the neighbouring
+// columns, so the columns are grouped into 2x2 tiles coloured like a checkerboard and the tiles of one colour are lit
+// in parallel at a time. Tiles of the same colour are a tile apart and never write to the same chunk. Light settles to
+// the brightest value any source gives it, so the order the tiles finish in does not change the result. ChunkController
+// lights newly generated and loaded columns with light_new_columns on the renderer's thread pool.
+class LightScheduler {
+public:
+    // The pool can be shared with other work, only the tasks of the scheduler are waited for
+    explicit LightScheduler(BS::thread_pool& thread_pool);
+
+    // Blocks until the columns are lit. Chunks must not be added to or removed from world_data in the meantime.
+    void relight_columns(WorldData& world_data, std::span<const nnm::Vector2i> columns);
+
+    // Lights columns that were just generated or loaded next to columns that are already lit. The new columns are lit
+    // from scratch and the generated columns around them spread their light again, so sunlight and emitters in the
+    // neighbours reach into the new columns. Light in the neighbours can only grow, as lighting only raises values.
+    void light_new_columns(WorldData& world_data, std::span<const nnm::Vector2i> columns);
+
+    [[nodiscard]] size_t thread_count() const
+    {
+        return m_thread_pool->get_thread_count();
+    }
+
+private:
+    // Resets reset_columns then spreads the light of the columns in m_sorted_columns
+    void light_columns(WorldData& world_data, std::span<const nnm::Vector2i> reset_columns);
+
+    BS::thread_pool* m_thread_pool;
+    // Columns to spread light from sorted by tile colour then tile, kept between calls to reuse the allocation
+    std::vector<nnm::Vector2i> m_sorted_columns {};
+    BS::multi_future<void> m_tasks {};
+};
@@ -0,0 +1,69 @@
+#include "light_storage.hpp"
+
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t sc_low_nibbles = 0x0F0F0F0F0F0F0F0F;
+constexpr uint64_t sc_byte_ones = 0x0101010101010101;
+
+// Replaces the nibbles selected by keep_mask's complement in every byte. Works on 64-bit words so the compiler can
+// vectorise it further, sc_volume is a multiple of the word size so there is no tail.
+void fill_nibbles(std::vector<uint8_t>& data, const uint64_t keep_mask, const uint64_t value)
+{
+    static_assert(LightStorage::sc_volume % sizeof(uint64_t) == 0);
+    for (size_t i = 0; i < data.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + i, sizeof(uint64_t));
+        word = (word & keep_mask) | value;
+        std::memcpy(data.data() + i, &word, sizeof(uint64_t));
+    }
+}
+
+}
+
+void LightStorage::fill_sky(const uint8_t value)
+{
+    VV_DEB_ASSERT(value <= 15, "[LightStorage] Sky light is not between 0 and 15")
+    if (m_data.empty()) {
+        m_uniform = static_cast<uint8_t>((m_uniform & 0xF0) | value);
+        return;
+    }
+    fill_nibbles(m_data, ~sc_low_nibbles, value * sc_byte_ones);
+    try_make_uniform();
+}
+
+void LightStorage::fill_block(const uint8_t value)
+{
+    VV_DEB_ASSERT(value <= 15, "[LightStorage] Block light is not between 0 and 15")
+    if (m_data.empty()) {
+        m_uniform = static_cast<uint8_t>((m_uniform & 0x0F) | value << 4);
+        return;
+    }
+    fill_nibbles(m_data, sc_low_nibbles, (value * sc_byte_ones) << 4);
+    try_make_uniform();
+}
+
+void LightStorage::copy_to(const std::span<uint8_t, sc_volume> out) const
+{
+    if (m_data.empty()) {
+        std::memset(out.data(), m_uniform, out.size());
+    }
+    else {
+        std::memcpy(out.data(), m_data.data(), out.size());
+    }
+}
+
+void LightStorage::try_make_uniform()
+{
+    const uint64_t first = m_data[0] * sc_byte_ones;
+    for (size_t i = 0; i < m_data.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, m_data.data() + i, sizeof(uint64_t));
+        if (word != first) {
+            return;
+        }
+    }
+    m_uniform = m_data[0];
+    std::vector<uint8_t>().swap(m_data);
+}
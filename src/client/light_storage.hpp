@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <cereal/details/helpers.hpp>
+// ReSharper disable once CppUnusedIncludeDirective
+#include <cereal/types/vector.hpp>
+
+#include "../common/assert.hpp"
+
+enum class LightChannel { sky, block };
+
+// Light of the 16^3 voxels of a chunk as two 4-bit channels packed into one byte per voxel, sky light in the low
+// nibble and block light in the high nibble. While every voxel has the same light no per-voxel array is allocated.
+class LightStorage {
+public:
+    static constexpr int sc_volume = 16 * 16 * 16;
+
+    [[nodiscard]] static constexpr uint8_t pack(const uint8_t sky, const uint8_t block)
+    {
+        return static_cast<uint8_t>(sky | block << 4);
+    }
+
+    [[nodiscard]] uint8_t packed(const size_t index) const
+    {
+        VV_DEB_ASSERT(index < sc_volume, "[LightStorage] Invalid index")
+        if (m_data.empty()) {
+            return m_uniform;
+        }
+        return m_data[index];
+    }
+
+    [[nodiscard]] uint8_t sky(const size_t index) const
+    {
+        return packed(index) & 0x0F;
+    }
+
+    [[nodiscard]] uint8_t block(const size_t index) const
+    {
+        return packed(index) >> 4;
+    }
+
+    // Brightest of the two channels, this is what gets rendered
+    [[nodiscard]] uint8_t combined(const size_t index) const
+    {
+        const uint8_t value = packed(index);
+        return std::max<uint8_t>(value & 0x0F, value >> 4);
+    }
+
+    void set_sky(const size_t index, const uint8_t value)
+    {
+        VV_DEB_ASSERT(value <= 15, "[LightStorage] Sky light is not between 0 and 15")
+        set_packed(index, static_cast<uint8_t>((packed(index) & 0xF0) | value));
+    }
+
+    void set_block(const size_t index, const uint8_t value)
+    {
+        VV_DEB_ASSERT(value <= 15, "[LightStorage] Block light is not between 0 and 15")
+        set_packed(index, static_cast<uint8_t>((packed(index) & 0x0F) | value << 4));
+    }
+
+    // Sets both channels of every voxel and releases the per-voxel array
+    void reset(const uint8_t sky, const uint8_t block)
+    {
+        VV_DEB_ASSERT(sky <= 15 && block <= 15, "[LightStorage] Light is not between 0 and 15")
+        // Swapped rather than cleared, clearing keeps the capacity
+        std::vector<uint8_t>().swap(m_data);
+        m_uniform = pack(sky, block);
+    }
+
+    // Sets one channel of every voxel while keeping the other
+    void fill_sky(uint8_t value);
+    void fill_block(uint8_t value);
+
+    // Writes the packed light of every voxel into out
+    void copy_to(std::span<uint8_t, sc_volume> out) const;
+
+    [[nodiscard]] std::optional<uint8_t> uniform() const
+    {
+        if (!m_data.empty()) {
+            return {};
+        }
+        return m_uniform;
+    }
+
+    [[nodiscard]] bool is_uniform() const
+    {
+        return m_data.empty();
+    }
+
+    [[nodiscard]] size_t memory_usage() const
+    {
+        return m_data.capacity() * sizeof(uint8_t);
+    }
+
+    template <class Archive>
+    void save(Archive& archive) const
+    {
+        archive(m_data, m_uniform);
+    }
+
+    // Throws cereal::Exception if the per-voxel array has the wrong size
+    template <class Archive>
+    void load(Archive& archive)
+    {
+        archive(m_data, m_uniform);
+        if (!m_data.empty() && m_data.size() != sc_volume) {
+            throw cereal::Exception("[LightStorage] Invalid light array size");
+        }
+    }
+
+private:
+    void set_packed(const size_t index, const uint8_t value)
+    {
+        if (m_data.empty()) {
+            if (value == m_uniform) {
+                return;
+            }
+            m_data.assign(sc_volume, m_uniform);
+        }
+        m_data[index] = value;
+    }
+
+    // Releases the per-voxel array if every voxel ended up with the same light
+    void try_make_uniform();
+
+    std::vector<uint8_t> m_data {};
+    uint8_t m_uniform = 0;
+};
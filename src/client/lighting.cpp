@@ -1,130 +1,202 @@
 #include "lighting.hpp"
 
+#include <algorithm>
+
 #include "chunk_column.hpp"
 #include "world_data.hpp"
 #include <game_performance_profiler.hpp>
 
-void apply_sunlight(ChunkColumn& chunk)
+namespace {
+
+constexpr std::array<nnm::Vector3i, 6> c_adjacent {
+    { { 0, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 }, { 0, -1, 0 }, { 1, 0, 0 }, { -1, 0, 0 } }
+};
+
+// Voxel in the 3x3x3 chunks around the chunk being lit, positioned from the corner of the chunk at offset (-1, -1, -1)
+// so each coordinate is between 0 and 47 and its upper two bits pick the chunk
+struct LightNode {
+    uint8_t x;
+    uint8_t y;
+    uint8_t z;
+    uint8_t light;
+
+    static LightNode from_local(const nnm::Vector3i local_pos, const uint8_t light)
+    {
+        return { static_cast<uint8_t>(local_pos.x + 16),
+                 static_cast<uint8_t>(local_pos.y + 16),
+                 static_cast<uint8_t>(local_pos.z + 16),
+                 light };
+    }
+};
+
+// Cleared and reused by every call on the same thread so chunks can be lit in parallel
+std::vector<LightNode>& light_queue()
+{
+    thread_local std::vector<LightNode> queue;
+    queue.clear();
+    return queue;
+}
+
+// Spreads the light of the queued voxels of the chunk at chunk_pos breadth first. Light starting in the chunk runs out
+// within 14 voxels so it never leaves the neighbouring chunks.
+void spread_light(
+    WorldData& world_data, const nnm::Vector3i chunk_pos, const LightChannel channel, std::vector<LightNode>& queue)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    for_2d({ 0, 0 }, { 16, 16 }, [&](const nnm::Vector2i offset) {
-        const nnm::Vector2i world_col = block_local_to_world_col(chunk.pos(), offset);
-        bool covered = false;
-        for (int i = 9 * 16; i >= -10 * 16; --i) {
-            const nnm::Vector3i world_pos { world_col.x, world_col.y, i };
-            if (!covered) {
-                if (!is_transparent(chunk.get_block(world_pos))) {
-                    covered = true;
-                }
-                else {
-                    chunk.set_lighting(world_pos, 15);
-                }
+    // Indexed by [dz][dy][dx] of the chunk offset plus one, nullptr where no chunk is loaded
+    std::array<ChunkData*, 27> chunks {};
+    for_3d({ 0, 0, 0 }, { 3, 3, 3 }, [&](const nnm::Vector3i offset) {
+        if (const nnm::Vector3i pos = chunk_pos + offset - nnm::Vector3i(1, 1, 1); world_data.contains_chunk(pos)) {
+            chunks[offset.x + offset.y * 3 + offset.z * 9] = &world_data.chunk_data_at(pos);
+        }
+    });
+
+    while (!queue.empty()) {
+        const LightNode node = queue.back();
+        queue.pop_back();
+        for (const nnm::Vector3i offset : c_adjacent) {
+            const nnm::Vector3i adj_pos = nnm::Vector3i(node.x, node.y, node.z) + offset;
+            VV_DEB_ASSERT(adj_pos.x >= 0 && adj_pos.x < 48 && adj_pos.y >= 0 && adj_pos.y < 48 && adj_pos.z >= 0
+                              && adj_pos.z < 48,
+                          "[Lighting] Light left the neighbouring chunks")
+            ChunkData* chunk = chunks[(adj_pos.x >> 4) + (adj_pos.y >> 4) * 3 + (adj_pos.z >> 4) * 9];
+            if (chunk == nullptr) {
+                continue;
+            }
+            const nnm::Vector3i local_pos { adj_pos.x & 15, adj_pos.y & 15, adj_pos.z & 15 };
+            const uint8_t block_type = chunk->get_block(local_pos);
+            if (!lets_light_through(block_type) || node.light <= 1 + light_opacity(block_type)) {
+                continue;
             }
-            else {
-                chunk.set_lighting(world_pos, 0);
+            const auto val = static_cast<uint8_t>(node.light - 1 - light_opacity(block_type));
+            if (chunk->light_at(channel, local_pos) >= val) {
+                continue;
+            }
+            chunk->set_light(channel, local_pos, val);
+            if (val > 1) {
+                queue.push_back({ static_cast<uint8_t>(adj_pos.x),
+                                  static_cast<uint8_t>(adj_pos.y),
+                                  static_cast<uint8_t>(adj_pos.z),
+                                  val });
             }
         }
-    });
+    }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
-void propagate_light(WorldData& world_data, const nnm::Vector3i chunk_pos)
-{
-    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    static std::vector<std::pair<nnm::Vector3i, uint8_t>> queue;
-    queue.clear();
 
-    const std::array<nnm::Vector3i, 6> adjacent
-        = { { { 0, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 }, { 0, -1, 0 }, { 1, 0, 0 }, { -1, 0, 0 } } };
+}
 
-    std::array<nnm::Vector3i, 26> surr_pos {};
-    {
-        int i = 0;
-        for_3d({ -1, -1, -1 }, { 2, 2, 2 }, [&](const nnm::Vector3i pos) {
-            surr_pos[i] = pos;
-            ++i;
+void apply_sunlight(ChunkColumn& chunk)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    const std::array<int16_t, 16 * 16>& heightmap = chunk.heightmap();
+    const auto [min_height, max_height] = std::ranges::minmax(heightmap);
+    for (int h = 9; h >= -10; --h) {
+        ChunkData& data = chunk.chunk_data_at({ chunk.pos().x, chunk.pos().y, h });
+        const int bottom = h * 16;
+        // Uniform fast paths, the chunk is either entirely in shadow or entirely in open sky
+        if (max_height < bottom) {
+            data.fill_sky_light(15);
+            continue;
+        }
+        if (min_height >= bottom + 15) {
+            data.fill_sky_light(0);
+            continue;
+        }
+        // Sunlight reaches down to just above the highest opaque block of each block column
+        for_2d({ 0, 0 }, { 16, 16 }, [&](const nnm::Vector2i col) {
+            const int lit_from = std::clamp(heightmap[col.x + col.y * 16] + 1 - bottom, 0, 16);
+            data.set_sky_light_span(col, 0, lit_from, 0);
+            data.set_sky_light_span(col, lit_from, 16, 15);
         });
     }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
 
-    ChunkData& current_chunk_data = world_data.chunk_data_at(chunk_pos);
-    std::array<std::optional<ChunkData*>, 26> surr_chunks {};
-    for (int i = 0; i < surr_pos.size(); ++i) {
-        if (world_data.contains_chunk(chunk_pos + surr_pos[i])) {
-            surr_chunks[i] = &world_data.chunk_data_at(chunk_pos + surr_pos[i]);
-        }
+void propagate_light(WorldData& world_data, const nnm::Vector3i chunk_pos)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    std::vector<LightNode>& queue = light_queue();
+
+    const ChunkData& chunk_data = world_data.chunk_data_at(chunk_pos);
+    const std::optional<uint8_t> uniform_block = chunk_data.uniform_block();
+    const std::optional<uint8_t> uniform_sky_light = chunk_data.uniform_sky_light();
+    if (uniform_sky_light.has_value() && *uniform_sky_light < 15) {
+        // Nothing in the chunk is in sunlight
+        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+        return;
     }
 
-    auto fast_lighting_at = [&](const nnm::Vector3i pos) -> std::optional<uint8_t> {
-        const nnm::Vector3i offset = chunk_pos_from_block_pos(pos) - chunk_pos;
-        const nnm::Vector3i local_pos = block_world_to_local(pos);
-        if (offset == nnm::Vector3i(0, 0, 0)) {
-            return current_chunk_data.lighting_at(local_pos);
-        }
-        for (int i = 0; i < surr_chunks.size(); ++i) {
-            if (offset == surr_pos[i]) {
-                return surr_chunks[i].has_value()
-                    ? surr_chunks[i].value()->lighting_at(local_pos)
-                    : std::optional<uint8_t> {};
+    if (uniform_sky_light == 15 && uniform_block.has_value() && light_opacity(*uniform_block) == 0) {
+        // Fully lit open chunk, interior voxels cannot brighten anything so only seed the outer shell
+        for_2d({ 0, 0 }, { 16, 16 }, [&](const nnm::Vector2i col) {
+            const bool edge = col.x == 0 || col.x == 15 || col.y == 0 || col.y == 15;
+            for (int z = 0; z < 16; z += edge ? 1 : 15) {
+                queue.push_back(LightNode::from_local({ col.x, col.y, z }, 15));
             }
-        }
-        VV_DEB_ASSERT(false, "Unreachable");
-        return {};
-    };
-
-    auto fast_block_at = [&](const nnm::Vector3i pos) -> std::optional<uint8_t> {
-        const nnm::Vector3i offset = chunk_pos_from_block_pos(pos) - chunk_pos;
-        const nnm::Vector3i local_pos = block_world_to_local(pos);
-        if (offset == nnm::Vector3i(0, 0, 0)) {
-            return current_chunk_data.get_block(local_pos);
-        }
-        for (int i = 0; i < surr_chunks.size(); ++i) {
-            if (offset == surr_pos[i]) {
-                return surr_chunks[i].has_value()
-                    ? surr_chunks[i].value()->get_block(local_pos)
-                    : std::optional<uint8_t> {};
-            }
-        }
-        VV_DEB_ASSERT(false, "Unreachable");
-        return {};
-    };
-
-    auto fast_set_lighting = [&](const nnm::Vector3i pos, const uint8_t val) {
-        const nnm::Vector3i offset = chunk_pos_from_block_pos(pos) - chunk_pos;
-        const nnm::Vector3i local_pos = block_world_to_local(pos);
-        if (offset == nnm::Vector3i(0, 0, 0)) {
-            return current_chunk_data.set_lighting(local_pos, val);
-        }
-        for (int i = 0; i < surr_chunks.size(); ++i) {
-            if (offset == surr_pos[i]) {
-                surr_chunks[i].value()->set_lighting(local_pos, val);
-                return;
+        });
+    }
+    else {
+        for_3d({ 0, 0, 0 }, { 16, 16, 16 }, [&](const nnm::Vector3i pos) {
+            if (chunk_data.sky_light_at(pos) >= 15) {
+                queue.push_back(LightNode::from_local(pos, 15));
             }
-        }
-        VV_DEB_ASSERT(false, "Unreachable");
-    };
+        });
+    }
+    spread_light(world_data, chunk_pos, LightChannel::sky, queue);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void propagate_block_light(WorldData& world_data, const nnm::Vector3i chunk_pos)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    std::vector<LightNode>& queue = light_queue();
 
+    ChunkData& chunk_data = world_data.chunk_data_at(chunk_pos);
+    if (!chunk_data.blocks().contains_if(is_emissive)) {
+        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+        return;
+    }
     for_3d({ 0, 0, 0 }, { 16, 16, 16 }, [&](const nnm::Vector3i pos) {
-        const nnm::Vector3i world_pos = block_local_to_world(chunk_pos, pos);
-        if (const std::optional<uint8_t> block = fast_block_at(world_pos);
-            fast_lighting_at(world_pos) >= 15 || (block.has_value() && block.value() == 9)) {
-            queue.emplace_back(world_pos, 15);
-        }
-    });
-    while (!queue.empty()) {
-        const auto [pos, prev_val] = queue.back();
-        queue.pop_back();
-        for (const nnm::Vector3i offset : adjacent) {
-            const nnm::Vector3i adj_pos = pos + offset;
-            const std::optional<uint8_t> current_lighting = fast_lighting_at(adj_pos);
-            // ReSharper disable once CppTooWideScopeInitStatement
-            const std::optional<uint8_t> block_type = fast_block_at(adj_pos);
-            if (block_type.has_value() && current_lighting.has_value() && current_lighting < prev_val - 1
-                && is_transparent(block_type.value())) {
-                fast_set_lighting(adj_pos, prev_val - 1);
-                if (prev_val - 1 > 1) {
-                    queue.emplace_back(adj_pos, prev_val - 1);
-                }
+        if (const uint8_t emission = light_emission(chunk_data.get_block(pos)); emission > 0) {
+            if (chunk_data.block_light_at(pos) < emission) {
+                chunk_data.set_block_light(pos, emission);
             }
+            queue.push_back(LightNode::from_local(pos, emission));
         }
+    });
+    spread_light(world_data, chunk_pos, LightChannel::block, queue);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void reset_column_light(ChunkColumn& column)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    for (int h = -10; h < 10; ++h) {
+        column.chunk_data_at({ column.pos().x, column.pos().y, h }).reset_lighting();
+    }
+    apply_sunlight(column);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void propagate_column_light(WorldData& world_data, const nnm::Vector2i column_pos)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    for (int h = -10; h < 10; ++h) {
+        propagate_light(world_data, { column_pos.x, column_pos.y, h });
+        propagate_block_light(world_data, { column_pos.x, column_pos.y, h });
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void relight_columns(WorldData& world_data, const std::span<const nnm::Vector2i> columns)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    for (const nnm::Vector2i column_pos : columns) {
+        reset_column_light(world_data.chunk_column_data_at(column_pos));
+    }
+    for (const nnm::Vector2i column_pos : columns) {
+        propagate_column_light(world_data, column_pos);
     }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
@@ -136,7 +208,7 @@ void refresh_lighting(WorldData& world_data, const nnm::Vector3i chunk_pos)
 
     for_3d({ -1, -1, -1 }, { 2, 2, 2 }, [&](const nnm::Vector3i offset) {
         if (world_data.contains_chunk(chunk_pos + offset)) {
-            world_data.chunk_data_at(chunk_pos + offset).reset_lighting(0);
+            world_data.chunk_data_at(chunk_pos + offset).reset_lighting();
         }
     });
 
@@ -149,6 +221,7 @@ void refresh_lighting(WorldData& world_data, const nnm::Vector3i chunk_pos)
     for_3d({ -1, -1, -1 }, { 2, 2, 2 }, [&](const nnm::Vector3i offset) {
         if (world_data.contains_chunk(chunk_pos + offset)) {
             propagate_light(world_data, chunk_pos + offset);
+            propagate_block_light(world_data, chunk_pos + offset);
         }
     });
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
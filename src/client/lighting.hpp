@@ -2,6 +2,8 @@
 
 #include "common.hpp"
 
+#include <span>
+
 #include <nnm/nnm.hpp>
 
 class WorldData;
@@ -11,4 +13,18 @@ void apply_sunlight(ChunkColumn& chunk);
 
 void propagate_light(WorldData& world_data, nnm::Vector3i chunk_pos);
 
+// Spreads block light from the emissive blocks of the chunk into it and its neighbours, chunks without emissive blocks
+// return straight away
+void propagate_block_light(WorldData& world_data, nnm::Vector3i chunk_pos);
+
+// Clears both light channels of the column and fills in its sunlight
+void reset_column_light(ChunkColumn& column);
+
+// Spreads sky and block light from every chunk of the column into it and its neighbouring columns
+void propagate_column_light(WorldData& world_data, nnm::Vector2i column_pos);
+
+// Lights the columns from scratch, light spreading out of them is added to the light of their neighbouring columns.
+// LightScheduler does the same on a thread pool.
+void relight_columns(WorldData& world_data, std::span<const nnm::Vector2i> columns);
+
 void refresh_lighting(WorldData& world_data, nnm::Vector3i chunk_pos);
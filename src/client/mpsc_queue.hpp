@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+
+// Lock-free queue of intrusive nodes with many producers and a single consumer. T must have a T* next member which
+// the queue uses while a node is in it. Producers push onto a stack with a compare and swap and the consumer takes
+// every pushed node in a single exchange, so nodes are never popped individually and there is no ABA problem.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() = default;
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Safe to call from any thread
+    void push(T* node)
+    {
+        T* head = m_head.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Removes every node pushed so far and returns them linked through next in the order they were pushed, only one
+    // thread may pop
+    [[nodiscard]] T* pop_all()
+    {
+        T* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        T* ordered = nullptr;
+        while (node != nullptr) {
+            T* next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+        return ordered;
+    }
+
+private:
+    std::atomic<T*> m_head = nullptr;
+};
@@ -59,6 +59,9 @@ Options load_options()
             break;
         }
     }
+    if (data.contains("mesh_cache_max_mb") && data["mesh_cache_max_mb"].is_number_unsigned()) {
+        options.mesh_cache_max_memory = data["mesh_cache_max_mb"].get<size_t>() * 1024 * 1024;
+    }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     return options;
 }
@@ -86,6 +89,8 @@ void set_options(const Options& options)
     };
 
     std::ofstream file("options.json");
-    const json data = { { "fullscreen", options.fullscreen }, { "msaa", msaa_int(options.msaa) } };
+    const json data = { { "fullscreen", options.fullscreen },
+                        { "msaa", msaa_int(options.msaa) },
+                        { "mesh_cache_max_mb", options.mesh_cache_max_memory / (1024 * 1024) } };
     file << std::setw(4) << data << std::endl;
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstddef>
+
 #include <mve/renderer.hpp>
 
 struct Options {
     bool fullscreen = false;
     mve::Msaa msaa = mve::Msaa::samples_1;
+    // Memory the cache of chunk meshes may take, saved in megabytes, 0 disables it
+    size_t mesh_cache_max_memory = 64 * 1024 * 1024;
 };
 
 Options load_options();
@@ -61,6 +61,17 @@ void Player::fixed_update(const mve::Window& window, const WorldData& data, cons
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     m_prev_pos = m_pos;
+    if (m_flight_path_tick.has_value()) {
+        // Two blocks per tick at 60 ticks per second is about 7 chunks per second for 20 seconds
+        constexpr float speed = 2.0f;
+        constexpr int duration = 60 * 20;
+        m_pos = m_pos.translate({ 0.0f, speed, 0.0f });
+        if (++*m_flight_path_tick >= duration) {
+            m_flight_path_tick.reset();
+        }
+        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+        return;
+    }
     const bool on_ground = is_on_ground(data);
     nnm::Vector3f dir;
     if (capture_input) {
@@ -137,6 +148,17 @@ void Player::fixed_update(const mve::Window& window, const WorldData& data, cons
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
+void Player::start_flight_path()
+{
+    // Above the highest terrain, looking along the path
+    m_pos = { 0.0f, 0.0f, 100.0f };
+    m_prev_pos = m_pos;
+    m_head_rotation = nnm::Vector2f::zero();
+    m_velocity = nnm::Vector3f::zero();
+    m_is_flying = true;
+    m_flight_path_tick = 0;
+}
+
 nnm::Vector3f Player::move_and_slide(
     BoundingBox box, nnm::Vector3f& pos, const nnm::Vector3f velocity, const WorldData& data)
 {
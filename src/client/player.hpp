@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
 
 #include <cereal/cereal.hpp>
 #include <nnm/nnm.hpp>
@@ -25,6 +26,15 @@ public:
     void update(const mve::Window& window, bool capture_input);
     void fixed_update(const mve::Window& window, const WorldData& data, bool capture_input);
 
+    // Flies a fixed straight line at a fixed speed from a fixed start, ignoring input and collisions, so frame times
+    // while streaming terrain can be compared between builds
+    void start_flight_path();
+
+    [[nodiscard]] bool is_on_flight_path() const
+    {
+        return m_flight_path_tick.has_value();
+    }
+
     [[nodiscard]] nnm::Vector3f position() const
     {
         return m_pos;
@@ -98,6 +108,7 @@ private:
     std::chrono::time_point<std::chrono::steady_clock> m_last_jump_time;
     std::chrono::time_point<std::chrono::steady_clock> m_last_space_time;
     bool m_is_flying;
+    std::optional<int> m_flight_path_tick {};
     util::FixedLoop m_save_loop;
     SaveFile m_save;
 
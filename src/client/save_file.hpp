@@ -39,6 +39,26 @@ public:
         return value;
     }
 
+    // Deserializes the value at key into an existing object instead of constructing a new one, returns false if there
+    // is no value at key
+    template <typename KeyType, typename ValueType>
+    bool read_into(const KeyType& key, ValueType& value)
+    {
+        std::stringstream key_stream;
+        {
+            cereal::PortableBinaryOutputArchive archive_out(key_stream);
+            archive_out(key);
+        }
+        std::optional<std::string> value_str = at(key_stream.str());
+        if (!value_str.has_value()) {
+            return false;
+        }
+        std::stringstream value_stream(*value_str);
+        cereal::PortableBinaryInputArchive archive_in(value_stream);
+        archive_in(value);
+        return true;
+    }
+
     template <typename KeyType>
     std::optional<std::string> at(const KeyType& key)
     {
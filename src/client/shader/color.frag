@@ -1,10 +1,17 @@
 #version 460
 
-layout (location = 0) in vec3 frag_color;
-layout (location = 1) in vec2 frag_tex_coord;
+layout (location = 0) in vec3 frag_position;
+layout (location = 1) in vec3 frag_color;
+layout (location = 2) in vec4 frag_fog_color;
+layout (location = 3) in float frag_fog_near;
+layout (location = 4) in float frag_fog_far;
+layout (location = 5) in float frag_fog_influence;
 
 layout (location = 0) out vec4 out_color;
 
 void main() {
-    out_color = vec4(frag_color, 1.0);
+    float fog_distance = length(frag_position);
+    float fog_amount = smoothstep(frag_fog_near, frag_fog_far, fog_distance) * frag_fog_influence;
+
+    out_color = mix(vec4(frag_color, 1.0), frag_fog_color, fog_amount);
 }
\ No newline at end of file
@@ -1,20 +1,36 @@
 #version 460
 
-layout (set = 0, binding = 0) uniform UniformBufferObject {
-    mat4 model;
+layout (set = 0, binding = 0) uniform GlobalUniform {
     mat4 view;
     mat4 proj;
-} ubo;
+    vec4 fog_color;
+    float fog_near;
+    float fog_far;
+} global_ubo;
+
+layout (set = 1, binding = 0) uniform ObjectUnifom {
+    mat4 model;
+    float fog_influence;
+} object_ubo;
 
 layout (location = 0) in vec3 in_pos;
 layout (location = 1) in vec3 in_color;
-layout (location = 2) in vec2 in_tex_coord;
 
-layout (location = 0) out vec3 frag_color;
-layout (location = 1) out vec2 frag_tex_coord;
+layout (location = 0) out vec3 frag_position;
+layout (location = 1) out vec3 frag_color;
+layout (location = 2) out vec4 frag_fog_color;
+layout (location = 3) out float frag_fog_near;
+layout (location = 4) out float frag_fog_far;
+layout (location = 5) out float frag_fog_influence;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(in_pos, 1.0);
+    vec4 view_pos = global_ubo.view * object_ubo.model * vec4(in_pos, 1.0);
+    gl_Position = global_ubo.proj * view_pos;
+
+    frag_position = view_pos.xyz;
     frag_color = in_color;
-    frag_tex_coord = in_tex_coord;
+    frag_fog_color = global_ubo.fog_color;
+    frag_fog_near = global_ubo.fog_near;
+    frag_fog_far = global_ubo.fog_far;
+    frag_fog_influence = object_ubo.fog_influence;
 }
\ No newline at end of file
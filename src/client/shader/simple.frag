@@ -10,14 +10,20 @@ layout (location = 4) in float frag_fog_near;
 layout (location = 5) in float frag_fog_far;
 layout (location = 6) in float frag_fog_depth;
 layout (location = 7) in float frag_fog_influence;
+layout (location = 8) flat in vec2 frag_atlas_tile;
+
+const vec2 atlas_size = vec2(4.0, 4.0);
 
 layout (location = 0) out vec4 out_color;
 
 void main() {
-    vec4 color = texture(tex_sampler, frag_tex_coord) * vec4(frag_color, 1.0);
-    if (color.a < 0.001) {
-        discard;
-    }
+    // Texture coordinates are in tiles so merged quads repeat the tile, gradients are taken before wrapping to keep
+    // mip selection continuous across tile seams
+    vec2 atlas_coord = (frag_atlas_tile + fract(frag_tex_coord)) / atlas_size;
+    vec2 grad_x = dFdx(frag_tex_coord) / atlas_size;
+    vec2 grad_y = dFdy(frag_tex_coord) / atlas_size;
+    // Opaque faces only, without a discard the depth test can run before shading
+    vec4 color = vec4(textureGrad(tex_sampler, atlas_coord, grad_x, grad_y).rgb * frag_color, 1.0);
 
     float fog_distance = length(frag_position);
     float fog_amount = smoothstep(frag_fog_near, frag_fog_far, fog_distance) * frag_fog_influence;
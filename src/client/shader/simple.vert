@@ -13,10 +13,9 @@ layout (set = 1, binding = 0) uniform ObjectUnifom {
     float fog_influence;
 } object_ubo;
 
-layout (location = 0) in vec3 in_pos;
-layout (location = 1) in vec3 in_color;
-layout (location = 2) in vec2 in_tex_coord;
-layout (location = 3) in float in_lighting;
+// See PackedChunkVertex in chunk_vertex.hpp
+layout (location = 0) in uint in_data;
+layout (location = 1) in uint in_quad;
 
 layout (location = 0) out vec3 frag_position;
 layout (location = 1) out vec3 frag_color;
@@ -26,16 +25,31 @@ layout (location = 4) out float frag_fog_near;
 layout (location = 5) out float frag_fog_far;
 layout (location = 6) out float frag_fog_depth;
 layout (location = 7) out float frag_fog_influence;
+layout (location = 8) flat out vec2 frag_atlas_tile;
+
+const float atlas_width = 4.0;
+
+// Texture coordinates of each face corner for a one block quad
+const vec2 corner_uvs[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
 
 void main() {
-    gl_Position = global_ubo.proj * global_ubo.view * object_ubo.model * vec4(in_pos, 1.0);
+    // Corners are stored from 0 to 16 while blocks are centred on integer positions
+    vec3 pos = vec3(in_data & 0x1Fu, (in_data >> 5) & 0x1Fu, (in_data >> 10) & 0x1Fu) - 0.5;
+    uint corner = (in_data >> 18) & 0x3u;
+    float atlas_tile = float((in_data >> 20) & 0xFu);
+    float light = float(in_data >> 24) / 255.0;
+    vec2 quad_size = vec2(in_quad & 0x1Fu, (in_quad >> 5) & 0x1Fu);
+
+    vec4 view_pos = global_ubo.view * object_ubo.model * vec4(pos, 1.0);
+    gl_Position = global_ubo.proj * view_pos;
 
-    frag_position = (global_ubo.view * vec4(in_pos, 1.0)).xyz;
-    frag_color = in_color;
-    frag_tex_coord = in_tex_coord;
+    frag_position = view_pos.xyz;
+    frag_color = vec3(light);
+    frag_tex_coord = corner_uvs[corner] * quad_size;
     frag_fog_color = global_ubo.fog_color;
     frag_fog_near = global_ubo.fog_near;
     frag_fog_far = global_ubo.fog_far;
-    frag_fog_depth = - (global_ubo.view * vec4(in_pos, 1.0)).z;
+    frag_fog_depth = -view_pos.z;
     frag_fog_influence = object_ubo.fog_influence;
+    frag_atlas_tile = vec2(mod(atlas_tile, atlas_width), floor(atlas_tile / atlas_width));
 }
\ No newline at end of file
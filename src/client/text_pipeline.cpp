@@ -29,15 +29,12 @@ TextPipeline::TextPipeline(mve::Renderer& renderer, const int point_size)
 {
     m_global_descriptor_set.write_binding(m_vert_shader.descriptor_set(0).binding(0), m_global_ubo);
 
+    constexpr std::array<Vertex, 4> vertices { { { { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f } },
+                                                 { { 1.0f, -1.0f, 0.0f }, { 1.0f, 0.0f } },
+                                                 { { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f } },
+                                                 { { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f } } } };
     mve::VertexData vertex_data(c_vertex_layout);
-    vertex_data.push_back({ 0.0f, -1.0f, 0.0f });
-    vertex_data.push_back({ 0.0f, 0.0f });
-    vertex_data.push_back({ 1.0f, -1.0f, 0.0f });
-    vertex_data.push_back({ 1.0f, 0.0f });
-    vertex_data.push_back({ 1.0f, 0.0f, 0.0f });
-    vertex_data.push_back({ 1.0f, 1.0f });
-    vertex_data.push_back({ 0.0f, 0.0f, 0.0f });
-    vertex_data.push_back({ 0.0f, 1.0f });
+    vertex_data.append_vertices<Vertex>(vertices);
     m_vertex_buffer = renderer.create_vertex_buffer(vertex_data);
     m_index_buffer = renderer.create_index_buffer({ 0, 3, 2, 0, 2, 1 });
 
@@ -45,15 +42,12 @@ TextPipeline::TextPipeline(mve::Renderer& renderer, const int point_size)
         m_vert_shader.descriptor_set(0).binding(0).member("view").location(),
         nnm::Transform3f().translate({ 0.0f, 0.0f, -1.0f }).matrix);
 
+    constexpr std::array<Vertex, 4> cursor_vertices { { { { -0.05f, -1.0f, 0.0f }, { 0.0f, 0.0f } },
+                                                        { { 0.05f, -1.0f, 0.0f }, { 1.0f, 0.0f } },
+                                                        { { 0.05f, 0.0f, 0.0f }, { 1.0f, 1.0f } },
+                                                        { { -0.05f, 0.0f, 0.0f }, { 0.0f, 1.0f } } } };
     mve::VertexData cursor_data(c_vertex_layout);
-    cursor_data.push_back({ -0.05f, -1.0f, 0.0f });
-    cursor_data.push_back({ 0.0f, 0.0f });
-    cursor_data.push_back({ 0.05f, -1.0f, 0.0f });
-    cursor_data.push_back({ 1.0f, 0.0f });
-    cursor_data.push_back({ 0.05f, 0.0f, 0.0f });
-    cursor_data.push_back({ 1.0f, 1.0f });
-    cursor_data.push_back({ -0.05f, 0.0f, 0.0f });
-    cursor_data.push_back({ 0.0f, 1.0f });
+    cursor_data.append_vertices<Vertex>(cursor_vertices);
     m_cursor_vertex_buffer = renderer.create_vertex_buffer(cursor_data);
     m_cursor_index_buffer = renderer.create_index_buffer({ 0, 3, 2, 0, 2, 1 });
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include <mve/renderer.hpp>
 
 class TextBuffer;
@@ -85,11 +87,18 @@ private:
         std::string text;
     };
 
-    const mve::VertexLayout c_vertex_layout = {
-        mve::VertexAttributeType::vec3, // Position
-        mve::VertexAttributeType::vec2 // UV
+    struct Vertex {
+        nnm::Vector3f position;
+        nnm::Vector2f uv;
+
+        static constexpr std::array attributes {
+            mve::VertexAttributeType::vec3, // Position
+            mve::VertexAttributeType::vec2 // UV
+        };
     };
 
+    const mve::VertexLayout c_vertex_layout = mve::vertex_layout<Vertex>();
+
     mve::Renderer* m_renderer;
     mve::Shader m_vert_shader;
     mve::Shader m_frag_shader;
@@ -18,19 +18,13 @@ Crosshair::Crosshair(UIPipeline& pipeline)
     constexpr float cross_scale = 25.0f;
     const nnm::Vector3 cross_color { 0.75f, 0.75f, 0.75f };
 
+    const std::array<UIVertex, 4> vertices { {
+        { nnm::Vector3f(-0.5f, -0.5f, 0.0f) * cross_scale, cross_color, { 0.0f, 0.0f } },
+        { nnm::Vector3f(0.5f, -0.5f, 0.0f) * cross_scale, cross_color, { 1.0f, 0.0f } },
+        { nnm::Vector3f(0.5f, 0.5f, 0.0f) * cross_scale, cross_color, { 1.0f, 1.0f } },
+        { nnm::Vector3f(-0.5f, 0.5f, 0.0f) * cross_scale, cross_color, { 0.0f, 1.0f } } } };
     mve::VertexData cross_data(UIPipeline::vertex_layout());
-    cross_data.push_back(nnm::Vector3f(-0.5f, -0.5f, 0.0f) * cross_scale);
-    cross_data.push_back(cross_color);
-    cross_data.push_back({ 0.0f, 0.0f });
-    cross_data.push_back(nnm::Vector3f(0.5f, -0.5f, 0.0f) * cross_scale);
-    cross_data.push_back(cross_color);
-    cross_data.push_back({ 1.0f, 0.0f });
-    cross_data.push_back(nnm::Vector3f(0.5f, 0.5f, 0.0f) * cross_scale);
-    cross_data.push_back(cross_color);
-    cross_data.push_back({ 1.0f, 1.0f });
-    cross_data.push_back(nnm::Vector3f(-0.5f, 0.5f, 0.0f) * cross_scale);
-    cross_data.push_back(cross_color);
-    cross_data.push_back({ 0.0f, 1.0f });
+    cross_data.append_vertices<UIVertex>(vertices);
 
     m_vertex_buffer = pipeline.renderer().create_vertex_buffer(cross_data);
     m_index_buffer = pipeline.renderer().create_index_buffer({ 0, 3, 2, 0, 2, 1 });
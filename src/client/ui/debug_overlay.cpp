@@ -6,17 +6,27 @@
 DebugOverlay::DebugOverlay(TextPipeline& text_pipeline)
     : m_fps_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
     , m_ms_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
+    , m_p99_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
     , m_gpu_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
     , m_build_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
     , m_player_block_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
     , m_player_chunk_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
+    , m_meshing_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
+    , m_remesh_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
+    , m_mesh_cache_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
+    , m_draw_sort_text(text_pipeline, "", { 0.0f, 0.0f }, 0.8f, c_text_color)
 {
     m_left_column.push_back(&m_fps_text);
     m_left_column.push_back(&m_ms_text);
+    m_left_column.push_back(&m_p99_text);
     m_left_column.push_back(&m_gpu_text);
     m_left_column.push_back(&m_build_text);
     m_left_column.push_back(&m_player_block_text);
     m_left_column.push_back(&m_player_chunk_text);
+    m_left_column.push_back(&m_meshing_text);
+    m_left_column.push_back(&m_remesh_text);
+    m_left_column.push_back(&m_mesh_cache_text);
+    m_left_column.push_back(&m_draw_sort_text);
 
 #ifdef NDEBUG
     std::snprintf(m_str_buffer.data(), m_str_buffer.size(), "build: optimized");
@@ -47,6 +57,14 @@ void DebugOverlay::update_fps(const int value)
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
+void DebugOverlay::update_frame_time_p99(const float ms)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    std::snprintf(m_str_buffer.data(), m_str_buffer.size(), "p99 ms: %.1f", ms);
+    m_p99_text.update(m_str_buffer.data());
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
 void DebugOverlay::resize()
 {
     m_left_column_pos = { 8.0f * 1.0f, 0.0f };
@@ -75,3 +93,53 @@ void DebugOverlay::update_player_block_pos(const nnm::Vector3i pos)
     m_player_chunk_text.update(m_str_buffer.data());
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
+
+void DebugOverlay::update_meshing_mode(const MeshingMode mode)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    std::snprintf(
+        m_str_buffer.data(), m_str_buffer.size(), "meshing: %s", mode == MeshingMode::greedy ? "greedy" : "naive");
+    m_meshing_text.update(m_str_buffer.data());
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void DebugOverlay::update_remesh_per_edit(const int chunk_count)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    std::snprintf(m_str_buffer.data(), m_str_buffer.size(), "remesh/edit: %d", chunk_count);
+    m_remesh_text.update(m_str_buffer.data());
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void DebugOverlay::update_mesh_cache(const ChunkMeshCache::Stats& stats)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    const uint64_t lookups = stats.hits + stats.misses;
+    const double hit_rate = lookups == 0 ? 0.0 : 100.0 * static_cast<double>(stats.hits) / static_cast<double>(lookups);
+    constexpr double mib = 1024.0 * 1024.0;
+    std::snprintf(
+        m_str_buffer.data(),
+        m_str_buffer.size(),
+        "mesh cache: %.1f%% hit, %zu meshes, %.1f/%.0f MiB",
+        hit_rate,
+        stats.entry_count,
+        static_cast<double>(stats.memory_usage) / mib,
+        static_cast<double>(stats.max_memory) / mib);
+    m_mesh_cache_text.update(m_str_buffer.data());
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void DebugOverlay::update_draw_sort(
+    const std::chrono::nanoseconds frame_time, const std::chrono::nanoseconds resort_time)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    using microseconds = std::chrono::duration<double, std::micro>;
+    std::snprintf(
+        m_str_buffer.data(),
+        m_str_buffer.size(),
+        "draw sort: %.1f us, last resort %.1f us",
+        std::chrono::duration_cast<microseconds>(frame_time).count(),
+        std::chrono::duration_cast<microseconds>(resort_time).count());
+    m_draw_sort_text.update(m_str_buffer.data());
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 
+#include "../chunk_mesh.hpp"
+#include "../chunk_mesh_cache.hpp"
 #include "../text_buffer.hpp"
 
 class DebugOverlay {
@@ -14,10 +17,23 @@ public:
 
     void update_fps(int value);
 
+    // 99th percentile frame time over the last second
+    void update_frame_time_p99(float ms);
+
     void update_gpu_name(const std::string& gpu);
 
     void update_player_block_pos(nnm::Vector3i pos);
 
+    void update_meshing_mode(MeshingMode mode);
+
+    // Chunks remeshed by the last block edit
+    void update_remesh_per_edit(int chunk_count);
+
+    void update_mesh_cache(const ChunkMeshCache::Stats& stats);
+
+    // Time spent ordering chunks for drawing last frame and on the most recent reorder
+    void update_draw_sort(std::chrono::nanoseconds frame_time, std::chrono::nanoseconds resort_time);
+
 private:
     const nnm::Vector3f c_text_color = { 0.0f, 0.0f, 0.0f };
 
@@ -30,8 +46,13 @@ private:
 
     TextBuffer m_fps_text;
     TextBuffer m_ms_text;
+    TextBuffer m_p99_text;
     TextBuffer m_gpu_text;
     TextBuffer m_build_text;
     TextBuffer m_player_block_text;
     TextBuffer m_player_chunk_text;
+    TextBuffer m_meshing_text;
+    TextBuffer m_remesh_text;
+    TextBuffer m_mesh_cache_text;
+    TextBuffer m_draw_sort_text;
 };
\ No newline at end of file
@@ -14,19 +14,13 @@ Hotbar::Hotbar(UIPipeline& ui_pipeline)
     , m_select_pos(0)
 {
     constexpr nnm::Vector2 size { 910, 110 };
+    const std::array<UIVertex, 4> vertices { {
+        { { -0.5f * size.x, -1.0f * size.y, 0.0f }, { 1, 1, 1 }, { 0.0f, 0.0f } },
+        { { 0.5f * size.x, -1.0f * size.y, 0.0f }, { 1, 1, 1 }, { 1.0f, 0.0f } },
+        { { 0.5f * size.x, 0.0f * size.y, 0.0f }, { 1, 1, 1 }, { 1.0f, 1.0f } },
+        { { -0.5f * size.x, 0.0f * size.y, 0.0f }, { 1, 1, 1 }, { 0.0f, 1.0f } } } };
     mve::VertexData vertex_data(UIPipeline::vertex_layout());
-    vertex_data.push_back(nnm::Vector3(-0.5f * size.x, -1.0f * size.y, 0.0f));
-    vertex_data.push_back({ 1, 1, 1 });
-    vertex_data.push_back({ 0.0f, 0.0f });
-    vertex_data.push_back(nnm::Vector3(0.5f * size.x, -1.0f * size.y, 0.0f));
-    vertex_data.push_back({ 1, 1, 1 });
-    vertex_data.push_back({ 1.0f, 0.0f });
-    vertex_data.push_back(nnm::Vector3(0.5f * size.x, 0.0f * size.y, 0.0f));
-    vertex_data.push_back({ 1, 1, 1 });
-    vertex_data.push_back({ 1.0f, 1.0f });
-    vertex_data.push_back(nnm::Vector3(-0.5f * size.x, 0.0f * size.y, 0.0f));
-    vertex_data.push_back({ 1, 1, 1 });
-    vertex_data.push_back({ 0.0f, 1.0f });
+    vertex_data.append_vertices<UIVertex>(vertices);
 
     m_hotbar_texture = ui_pipeline.renderer().create_texture(res_path("hotbar.png"));
     m_hotbar.vertex_buffer = ui_pipeline.renderer().create_vertex_buffer(vertex_data);
@@ -35,19 +29,13 @@ Hotbar::Hotbar(UIPipeline& ui_pipeline)
     m_hotbar.uniform_data.buffer.update(m_model_location, nnm::Matrix4f::identity());
 
     constexpr nnm::Vector2 select_size { 24 * 5, 23 * 5 };
+    const std::array<UIVertex, 4> select_vertices { {
+        { { -0.5f * select_size.x, -1.0f * select_size.y, 0.0f }, { 1, 1, 1 }, { 0.0f, 0.0f } },
+        { { 0.5f * select_size.x, -1.0f * select_size.y, 0.0f }, { 1, 1, 1 }, { 1.0f, 0.0f } },
+        { { 0.5f * select_size.x, 0.0f * select_size.y, 0.0f }, { 1, 1, 1 }, { 1.0f, 1.0f } },
+        { { -0.5f * select_size.x, 0.0f * select_size.y, 0.0f }, { 1, 1, 1 }, { 0.0f, 1.0f } } } };
     mve::VertexData select_vertex_data(UIPipeline::vertex_layout());
-    select_vertex_data.push_back(nnm::Vector3(-0.5f * select_size.x, -1.0f * select_size.y, 0.0f));
-    select_vertex_data.push_back({ 1, 1, 1 });
-    select_vertex_data.push_back({ 0.0f, 0.0f });
-    select_vertex_data.push_back(nnm::Vector3(0.5f * select_size.x, -1.0f * select_size.y, 0.0f));
-    select_vertex_data.push_back({ 1, 1, 1 });
-    select_vertex_data.push_back({ 1.0f, 0.0f });
-    select_vertex_data.push_back(nnm::Vector3(0.5f * select_size.x, 0.0f * select_size.y, 0.0f));
-    select_vertex_data.push_back({ 1, 1, 1 });
-    select_vertex_data.push_back({ 1.0f, 1.0f });
-    select_vertex_data.push_back(nnm::Vector3(-0.5f * select_size.x, 0.0f * select_size.y, 0.0f));
-    select_vertex_data.push_back({ 1, 1, 1 });
-    select_vertex_data.push_back({ 0.0f, 1.0f });
+    select_vertex_data.append_vertices<UIVertex>(select_vertices);
 
     m_select_texture = ui_pipeline.renderer().create_texture(res_path("hotbar_select.png"));
     m_select.vertex_buffer = ui_pipeline.renderer().create_vertex_buffer(select_vertex_data);
@@ -108,19 +96,13 @@ std::pair<mve::VertexData, std::vector<uint32_t>> Hotbar::create_item_mesh(const
     auto [top_left, top_right, bottom_right, bottom_left]
         = uvs_from_atlas({ 4, 4 }, block_uv(block_type, Direction::front));
 
+    const std::array<UIVertex, 4> vertices { {
+        { { -0.5f * size.x, -1.0f * size.y, 0.0f }, { 0.0f, 0.0f, 0.0f }, top_left },
+        { { 0.5f * size.x, -1.0f * size.y, 0.0f }, { 0.0f, 0.0f, 0.0f }, top_right },
+        { { 0.5f * size.x, 0.0f * size.y, 0.0f }, { 0.0f, 0.0f, 0.0f }, bottom_right },
+        { { -0.5f * size.x, 0.0f * size.y, 0.0f }, { 0.0f, 0.0f, 0.0f }, bottom_left } } };
     mve::VertexData data(UIPipeline::vertex_layout());
-    data.push_back(nnm::Vector3(-0.5f * size.x, -1.0f * size.y, 0.0f));
-    data.push_back({ 0.0f, 0.0f, 0.0f });
-    data.push_back(top_left);
-    data.push_back(nnm::Vector3(0.5f * size.x, -1.0f * size.y, 0.0f));
-    data.push_back({ 0.0f, 0.0f, 0.0f });
-    data.push_back(top_right);
-    data.push_back(nnm::Vector3(0.5f * size.x, 0.0f * size.y, 0.0f));
-    data.push_back({ 0.0f, 0.0f, 0.0f });
-    data.push_back(bottom_right);
-    data.push_back(nnm::Vector3(-0.5f * size.x, 0.0f * size.y, 0.0f));
-    data.push_back({ 0.0f, 0.0f, 0.0f });
-    data.push_back(bottom_left);
+    data.append_vertices<UIVertex>(vertices);
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     return { data, { 0, 3, 2, 0, 2, 1 } };
 }
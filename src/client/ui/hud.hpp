@@ -20,11 +20,36 @@ public:
         m_debug_overlay.update_fps(fps);
     }
 
+    void update_debug_frame_time_p99(const float ms)
+    {
+        m_debug_overlay.update_frame_time_p99(ms);
+    }
+
     void update_debug_gpu_name(const std::string& gpu)
     {
         m_debug_overlay.update_gpu_name(gpu);
     }
 
+    void update_debug_meshing_mode(const MeshingMode mode)
+    {
+        m_debug_overlay.update_meshing_mode(mode);
+    }
+
+    void update_debug_remesh_per_edit(const int chunk_count)
+    {
+        m_debug_overlay.update_remesh_per_edit(chunk_count);
+    }
+
+    void update_debug_mesh_cache(const ChunkMeshCache::Stats& stats)
+    {
+        m_debug_overlay.update_mesh_cache(stats);
+    }
+
+    void update_debug_draw_sort(const std::chrono::nanoseconds frame_time, const std::chrono::nanoseconds resort_time)
+    {
+        m_debug_overlay.update_draw_sort(frame_time, resort_time);
+    }
+
     void update_console(const mve::Window& window)
     {
         m_console.update_from_window(window);
@@ -69,12 +69,12 @@ NinePatch::NinePatch(
     };
     // clang-format on
 
-    mve::VertexData vertex_data(UIPipeline::vertex_layout());
+    std::array<UIVertex, 16> ui_vertices;
     for (int i = 0; i < 16; i++) {
-        vertex_data.push_back(nnm::Vector3(vertices[i].x, vertices[i].y, 0.0f));
-        vertex_data.push_back(nnm::Vector3(1.0f, 1.0f, 1.0f));
-        vertex_data.push_back(uvs[i]);
+        ui_vertices[i] = { { vertices[i].x, vertices[i].y, 0.0f }, { 1.0f, 1.0f, 1.0f }, uvs[i] };
     }
+    mve::VertexData vertex_data(UIPipeline::vertex_layout());
+    vertex_data.append_vertices<UIVertex>(ui_vertices);
     m_vertex_buffer = ui_pipeline.renderer().create_vertex_buffer(vertex_data);
     m_index_buffer = ui_pipeline.renderer().create_index_buffer(indices);
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
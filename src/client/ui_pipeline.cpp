@@ -39,19 +39,13 @@ void UIPipeline::update_framebuffer_texture(const mve::Texture& texture, const n
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     m_global_descriptor_set.write_binding(m_fragment_shader.descriptor_set(0).binding(1), texture);
+    const std::array<UIVertex, 4> vertices { {
+        { { 0.0f, 0.0f, 0.0f }, { 1, 1, 1 }, { 0.0f, 0.0f } },
+        { { static_cast<float>(size.x), 0.0f, 0.0f }, { 1, 1, 1 }, { 1.0f, 0.0f } },
+        { { static_cast<float>(size.x), static_cast<float>(size.y), 0.0f }, { 1, 1, 1 }, { 1.0f, 1.0f } },
+        { { 0.0f, static_cast<float>(size.y), 0.0f }, { 1, 1, 1 }, { 0.0f, 1.0f } } } };
     mve::VertexData world_data(vertex_layout());
-    world_data.push_back(nnm::Vector3(0.0f, 0.0f, 0.0f));
-    world_data.push_back({ 1, 1, 1 });
-    world_data.push_back({ 0.0f, 0.0f });
-    world_data.push_back(nnm::Vector3(static_cast<float>(size.x), 0.0f, 0.0f));
-    world_data.push_back({ 1, 1, 1 });
-    world_data.push_back({ 1.0f, 0.0f });
-    world_data.push_back(nnm::Vector3(static_cast<float>(size.x), static_cast<float>(size.y), 0.0f));
-    world_data.push_back({ 1, 1, 1 });
-    world_data.push_back({ 1.0f, 1.0f });
-    world_data.push_back(nnm::Vector3(0.0f, static_cast<float>(size.y), 0.0f));
-    world_data.push_back({ 1, 1, 1 });
-    world_data.push_back({ 0.0f, 1.0f });
+    world_data.append_vertices<UIVertex>(vertices);
     if (!m_world.has_value()) {
         World world { .vertex_buffer = m_renderer->create_vertex_buffer(world_data),
                       .index_buffer = m_renderer->create_index_buffer({ 0, 3, 2, 0, 2, 1 }),
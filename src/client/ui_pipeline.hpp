@@ -1,7 +1,21 @@
 #pragma once
 
+#include <array>
+
 #include <mve/renderer.hpp>
 
+struct UIVertex {
+    nnm::Vector3f position;
+    nnm::Vector3f color;
+    nnm::Vector2f uv;
+
+    static constexpr std::array attributes {
+        mve::VertexAttributeType::vec3, // Position
+        mve::VertexAttributeType::vec3, // Color
+        mve::VertexAttributeType::vec2 // UV
+    };
+};
+
 struct UIUniformData {
     mve::DescriptorSet descriptor_set;
     mve::UniformBuffer buffer;
@@ -48,11 +62,7 @@ public:
 
     static mve::VertexLayout vertex_layout()
     {
-        return {
-            mve::VertexAttributeType::vec3, // Position
-            mve::VertexAttributeType::vec3, // Color
-            mve::VertexAttributeType::vec2 // UV
-        };
+        return mve::vertex_layout<UIVertex>();
     }
 
 private:
@@ -4,7 +4,6 @@
 // Needed for GCC std::as_const
 #include <utility>
 
-#include "world_renderer.hpp"
 #include <game_performance_profiler.hpp>
 
 WireBoxMesh::WireBoxMesh(
@@ -24,7 +23,7 @@ WireBoxMesh::WireBoxMesh(
 
     m_uniform_buffer.update(uniform_buffer_binding.member("fog_influence").location(), 0.0f);
 
-    mve::VertexData data(WorldRenderer::vertex_layout());
+    mve::VertexData data(vertex_layout());
 
     Rect3 rect = bounding_box_to_rect3(box);
 
@@ -40,12 +39,12 @@ WireBoxMesh::WireBoxMesh(
         combine_mesh_data(combined_data, rect_mesh);
     }
 
+    std::vector<Vertex> vertices;
+    vertices.reserve(combined_data.vertices.size());
     for (const nnm::Vector3f& vertex : combined_data.vertices) {
-        data.push_back(vertex);
-        data.push_back(color); // TODO: Fix broken color
-        data.push_back({ 0, 0 });
-        data.push_back(1.0f);
+        vertices.push_back({ .position = vertex, .color = color });
     }
+    data.append_vertices<Vertex>(vertices);
 
     m_uniform_buffer.update(m_model_location, nnm::Matrix4f::identity());
 
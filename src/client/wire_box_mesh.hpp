@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "common.hpp"
 
 #include <nnm/nnm.hpp>
@@ -21,7 +23,22 @@ public:
 
     void draw(const mve::DescriptorSet& global_set) const;
 
+    static mve::VertexLayout vertex_layout()
+    {
+        return mve::vertex_layout<Vertex>();
+    }
+
 private:
+    struct Vertex {
+        nnm::Vector3f position;
+        nnm::Vector3f color;
+
+        static constexpr std::array attributes {
+            mve::VertexAttributeType::vec3, // Position
+            mve::VertexAttributeType::vec3 // Color
+        };
+    };
+
     struct MeshBuffers {
         mve::VertexBuffer vertex_buffer;
         mve::IndexBuffer index_buffer;
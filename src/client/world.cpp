@@ -2,7 +2,6 @@
 
 #include "chunk_data.hpp"
 #include "common.hpp"
-#include "lighting.hpp"
 #include "ui_pipeline.hpp"
 #include "world_data.hpp"
 #include <game_performance_profiler.hpp>
@@ -10,6 +9,7 @@
 World::World(mve::Renderer& renderer, UIPipeline& ui_pipeline, TextPipeline& text_pipeline, const int render_distance)
     : m_world_renderer(renderer)
     , m_world_generator(1)
+    , m_far_terrain_controller(m_world_generator)
     , m_render_distance(render_distance)
     , m_hud(ui_pipeline, text_pipeline)
     , m_pause_menu(ui_pipeline, text_pipeline)
@@ -19,7 +19,20 @@ World::World(mve::Renderer& renderer, UIPipeline& ui_pipeline, TextPipeline& tex
     , m_should_exit(false)
 {
     m_hud.update_debug_gpu_name(renderer.gpu_name());
-    m_chunk_controller.set_mesh_updates_per_frame(2).set_render_distance(render_distance);
+    m_hud.update_debug_meshing_mode(m_world_renderer.meshing_mode());
+    m_chunk_controller.set_mesh_updates_per_frame(2);
+    set_render_distance(render_distance);
+}
+
+void World::set_render_distance(const int distance)
+{
+    m_render_distance = distance;
+    m_chunk_controller.set_render_distance(distance);
+    m_far_terrain_controller.set_distances(distance, distance * sc_far_terrain_distance_scale);
+    // Fog hides the edge of whichever terrain reaches further, far terrain is only a few triangles per region so it
+    // can go several times further than the voxels
+    const auto view_distance = static_cast<float>(std::max(distance, m_far_terrain_controller.far_distance()) * 16);
+    m_world_renderer.set_fog_distance(view_distance * 0.78f, view_distance * 0.93f);
 }
 
 void World::fixed_update(const mve::Window& window)
@@ -122,7 +135,11 @@ RayCollision ray_box_collision(Ray ray, const BoundingBox& box)
 }
 
 void trigger_place_block(
-    const Player& camera, ChunkController& chunk_controller, WorldData& world_data, const uint8_t block_type)
+    const Player& camera,
+    ChunkController& chunk_controller,
+    LightEngine& light_engine,
+    WorldData& world_data,
+    const uint8_t block_type)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     const std::vector<nnm::Vector3i> blocks
@@ -149,20 +166,16 @@ void trigger_place_block(
                 break;
             }
             world_data.set_block(place_pos, block_type);
-            const nnm::Vector3i chunk_pos = chunk_pos_from_block_pos({ place_pos.x, place_pos.y, place_pos.z });
-
-            refresh_lighting(world_data, chunk_pos);
-
-            for_2d({ -1, -1 }, { 2, 2 }, [&](const nnm::Vector2i& surround_pos) {
-                chunk_controller.queue_recreate_mesh(nnm::Vector2i(chunk_pos.x, chunk_pos.y) + surround_pos);
-            });
+            light_engine.update_block(world_data, place_pos, 0);
+            chunk_controller.queue_block_edit(world_data, place_pos, light_engine);
             break;
         }
     }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
-void trigger_break_block(const Player& camera, ChunkController& chunk_controller, WorldData& world_data)
+void trigger_break_block(
+    const Player& camera, ChunkController& chunk_controller, LightEngine& light_engine, WorldData& world_data)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     const std::vector<nnm::Vector3i> blocks
@@ -177,13 +190,11 @@ void trigger_break_block(const Player& camera, ChunkController& chunk_controller
         if (auto [hit, distance, point, normal] = ray_box_collision(ray, bb); hit) {
             const nnm::Vector3i local_pos = block_world_to_local(block_pos);
             const nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(block_pos);
+            const uint8_t old_block = world_data.block_at_local(chunk_pos, local_pos);
 
             world_data.set_block_local(chunk_pos, local_pos, 0);
-            refresh_lighting(world_data, chunk_pos);
-
-            for_2d({ -1, -1 }, { 2, 2 }, [&](const nnm::Vector2i& surround_pos) {
-                chunk_controller.queue_recreate_mesh(nnm::Vector2i(chunk_pos.x, chunk_pos.y) + surround_pos);
-            });
+            light_engine.update_block(world_data, block_pos, old_block);
+            chunk_controller.queue_block_edit(world_data, block_pos, light_engine);
             break;
         }
     }
@@ -196,12 +207,25 @@ void World::update(mve::Window& window, const float blend, mve::Renderer& render
     if (window.is_key_pressed(mve::Key::f3)) {
         m_hud.toggle_debug();
     }
+    if (window.is_key_pressed(mve::Key::f4)) {
+        m_world_renderer.set_meshing_mode(
+            m_world_renderer.meshing_mode() == MeshingMode::greedy ? MeshingMode::naive : MeshingMode::greedy);
+        m_chunk_controller.queue_recreate_all_meshes();
+        m_hud.update_debug_meshing_mode(m_world_renderer.meshing_mode());
+    }
+    if (window.is_key_pressed(mve::Key::f8) && !m_player.is_on_flight_path()) {
+        m_player.start_flight_path();
+    }
     if (m_hud.is_debug_enabled()) {
         m_hud.update_debug_player_block_pos(m_player.block_position());
+        m_hud.update_debug_remesh_per_edit(m_chunk_controller.last_edit_remesh_count());
+        m_hud.update_debug_mesh_cache(m_world_renderer.mesh_cache_stats());
+        m_hud.update_debug_draw_sort(m_world_renderer.last_draw_sort_time(), m_world_renderer.last_draw_resort_time());
     }
 
-    m_player.update(window, m_focus == FocusState::world);
+    m_player.update(window, m_focus == FocusState::world && !m_player.is_on_flight_path());
     m_world_renderer.set_view(m_player.view_matrix(blend));
+    m_world_renderer.set_mesh_focus(m_player.position(), m_player.direction());
 
     switch (m_focus) {
     case FocusState::world:
@@ -245,8 +269,9 @@ void World::update(mve::Window& window, const float blend, mve::Renderer& render
         }
     }
 
-    m_chunk_controller.update(
-        m_world_data, m_world_generator, m_world_renderer, chunk_pos_from_block_pos(m_player.block_position()));
+    const nnm::Vector3i player_chunk = chunk_pos_from_block_pos(m_player.block_position());
+    m_chunk_controller.update(m_world_data, m_world_generator, m_world_renderer, player_chunk);
+    m_far_terrain_controller.update(m_world_renderer, { player_chunk.x, player_chunk.y });
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
@@ -292,12 +317,12 @@ void World::update_world(mve::Window& window)
     }
     const auto now = std::chrono::steady_clock::now();
     if (window.is_mouse_button_pressed(mve::MouseButton::left)) {
-        trigger_break_block(m_player, m_chunk_controller, m_world_data);
+        trigger_break_block(m_player, m_chunk_controller, m_light_engine, m_world_data);
         m_last_break_time = now;
     }
     if (window.is_mouse_button_down(mve::MouseButton::left)) {
         if (std::chrono::duration_cast<std::chrono::milliseconds>(now - m_last_break_time).count() > 200) {
-            trigger_break_block(m_player, m_chunk_controller, m_world_data);
+            trigger_break_block(m_player, m_chunk_controller, m_light_engine, m_world_data);
             m_last_break_time = now;
         }
     }
@@ -305,7 +330,11 @@ void World::update_world(mve::Window& window)
     if (window.is_mouse_button_pressed(mve::MouseButton::right)) {
         if (m_hud.hotbar().item_at(m_hud.hotbar().select_pos()).has_value()) {
             trigger_place_block(
-                m_player, m_chunk_controller, m_world_data, *m_hud.hotbar().item_at(m_hud.hotbar().select_pos()));
+                m_player,
+                m_chunk_controller,
+                m_light_engine,
+                m_world_data,
+                *m_hud.hotbar().item_at(m_hud.hotbar().select_pos()));
             m_last_place_time = now;
         }
     }
@@ -313,7 +342,11 @@ void World::update_world(mve::Window& window)
         if (m_hud.hotbar().item_at(m_hud.hotbar().select_pos()).has_value()) {
             if (std::chrono::duration_cast<std::chrono::milliseconds>(now - m_last_place_time).count() > 200) {
                 trigger_place_block(
-                    m_player, m_chunk_controller, m_world_data, *m_hud.hotbar().item_at(m_hud.hotbar().select_pos()));
+                    m_player,
+                    m_chunk_controller,
+                    m_light_engine,
+                    m_world_data,
+                    *m_hud.hotbar().item_at(m_hud.hotbar().select_pos()));
                 m_last_place_time = now;
             }
         }
@@ -3,6 +3,8 @@
 #include <mve/renderer.hpp>
 
 #include "chunk_controller.hpp"
+#include "far_terrain_controller.hpp"
+#include "light_engine.hpp"
 #include "text_pipeline.hpp"
 #include "ui/hud.hpp"
 #include "ui/pause_menu.hpp"
@@ -19,11 +21,8 @@ class World {
 public:
     World(mve::Renderer& renderer, UIPipeline& ui_pipeline, TextPipeline& text_pipeline, int render_distance);
 
-    void set_render_distance(const int distance)
-    {
-        m_render_distance = distance;
-        m_chunk_controller.set_render_distance(distance);
-    }
+    // Far terrain reaches sc_far_terrain_distance_scale times further than the voxel terrain
+    void set_render_distance(int distance);
 
     void fixed_update(const mve::Window& window);
 
@@ -33,11 +32,31 @@ public:
 
     void draw();
 
+    void set_mesh_cache_max_memory(const size_t max_memory)
+    {
+        m_world_renderer.set_mesh_cache_max_memory(max_memory);
+    }
+
+    [[nodiscard]] size_t mesh_cache_max_memory() const
+    {
+        return m_world_renderer.mesh_cache_stats().max_memory;
+    }
+
     void update_debug_fps(const int fps)
     {
         m_hud.update_debug_fps(fps);
     }
 
+    void update_debug_frame_time_p99(const float ms)
+    {
+        m_hud.update_debug_frame_time_p99(ms);
+    }
+
+    [[nodiscard]] bool is_on_flight_path() const
+    {
+        return m_player.is_on_flight_path();
+    }
+
     [[nodiscard]] nnm::Vector3i player_block_pos() const;
 
     [[nodiscard]] nnm::Vector3i player_chunk_pos() const;
@@ -57,13 +76,19 @@ public:
 private:
     enum class FocusState { world, console, pause };
 
+    static constexpr int sc_far_terrain_distance_scale = 4;
+
     void update_world(mve::Window& window);
 
     WorldRenderer m_world_renderer;
     WorldGenerator m_world_generator;
+    // Declared after the generator its background thread reads
+    FarTerrainController m_far_terrain_controller;
     WorldData m_world_data;
     Player m_player;
-    ChunkController m_chunk_controller {};
+    // Lights on the renderer's thread pool, which is constructed first
+    ChunkController m_chunk_controller { m_world_renderer.thread_pool() };
+    LightEngine m_light_engine {};
     int m_render_distance;
     HUD m_hud;
     PauseMenu m_pause_menu;
@@ -31,11 +31,16 @@ void WorldData::set_player_chunk(const nnm::Vector2i chunk_pos)
 std::optional<nnm::Vector2i> WorldData::try_cull_chunk(const float distance)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    if (m_sorted_chunks.empty()) {
+        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+        return {};
+    }
     if (nnm::Vector2i furthest_chunk = m_sorted_chunks[m_sorted_chunks.size() - 1];
         nnm::Vector2f(furthest_chunk).distance(nnm::Vector2f(m_player_chunk)) > distance) {
         if (m_save_queue.contains(furthest_chunk)) {
             process_save_queue();
         }
+        m_column_pool.release(m_chunk_columns.at(furthest_chunk));
         m_chunk_columns.erase(furthest_chunk);
         m_sorted_chunks.pop_back();
         PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
@@ -47,8 +52,8 @@ std::optional<nnm::Vector2i> WorldData::try_cull_chunk(const float distance)
 
 WorldData::~WorldData()
 {
-    for (auto& col : m_chunk_columns | std::views::values) {
-        queue_save_chunk(col.pos());
+    for (const auto& [pos, _] : m_chunk_columns) {
+        queue_save_chunk(pos);
     }
     process_save_queue();
 }
@@ -65,7 +70,8 @@ void WorldData::create_or_load_chunk(const nnm::Vector2i chunk_pos)
 void WorldData::create_chunk_column(nnm::Vector2i chunk_pos)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    if (auto [_, inserted] = m_chunk_columns.insert({ chunk_pos, ChunkColumn(chunk_pos) }); inserted) {
+    if (auto [column, inserted] = m_chunk_columns.try_emplace(chunk_pos, nullptr); inserted) {
+        *column = m_column_pool.acquire(chunk_pos);
         insert_sorted(m_sorted_chunks, chunk_pos, compare_from_player);
     }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
@@ -76,8 +82,8 @@ void WorldData::process_save_queue()
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     m_save.begin_batch();
     for (nnm::Vector2i pos : m_save_queue) {
-        if (m_chunk_columns.contains(pos)) {
-            m_save.insert<nnm::Vector2i, ChunkColumn>(pos, m_chunk_columns.at(pos));
+        if (const ChunkColumn* column = find_column(pos)) {
+            m_save.insert<nnm::Vector2i, ChunkColumn>(pos, *column);
         }
     }
     m_save.submit_batch();
@@ -90,7 +96,10 @@ void WorldData::remove_chunk_column(const nnm::Vector2i chunk_pos)
     if (m_save_queue.contains(chunk_pos)) {
         process_save_queue();
     }
-    m_chunk_columns.erase(chunk_pos);
+    if (ChunkColumn* column = find_column(chunk_pos)) {
+        m_column_pool.release(column);
+        m_chunk_columns.erase(chunk_pos);
+    }
     std::erase(m_sorted_chunks, chunk_pos);
 }
 
@@ -102,14 +111,27 @@ void WorldData::sort_chunks()
 bool WorldData::try_load_chunk_column_from_save(nnm::Vector2i chunk_pos)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    std::optional<ChunkColumn> data = m_save.at<nnm::Vector2i, ChunkColumn>(chunk_pos);
-    if (!data.has_value()) {
+    // Deserialize straight into pooled storage so no temporary column is constructed and copied
+    ChunkColumn* column = m_column_pool.acquire(chunk_pos);
+    bool loaded;
+    try {
+        loaded = m_save.read_into(chunk_pos, *column);
+    }
+    catch (const cereal::Exception&) {
+        // Saved with another version or corrupt, the column is generated again and overwritten on the next save
+        loaded = false;
+    }
+    if (!loaded) {
+        m_column_pool.release(column);
         PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
         return false;
     }
-    if (auto [_, inserted] = m_chunk_columns.insert({ chunk_pos, *data }); inserted) {
+    if (auto [_, inserted] = m_chunk_columns.try_emplace(chunk_pos, column); inserted) {
         insert_sorted(m_sorted_chunks, chunk_pos, compare_from_player);
     }
+    else {
+        m_column_pool.release(column);
+    }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     return true;
 }
\ No newline at end of file
@@ -3,14 +3,15 @@
 #include <functional>
 #include <optional>
 #include <set>
-#include <unordered_map>
 
 #include "common.hpp"
 
 #include <nnm/nnm.hpp>
 
 #include "chunk_column.hpp"
+#include "chunk_column_pool.hpp"
 #include "chunk_data.hpp"
+#include "chunk_map.hpp"
 #include "save_file.hpp"
 
 class WorldGenerator;
@@ -28,17 +29,18 @@ public:
         if (chunk_pos.z < -10 || chunk_pos.z >= 10) {
             return {};
         }
-        if (!m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y })) {
+        const ChunkColumn* column = find_column(chunk_pos);
+        if (column == nullptr) {
             return {};
         }
-        return m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).get_block(block_pos);
+        return column->get_block(block_pos);
     }
 
-    void set_lighting(const nnm::Vector3i pos, const uint8_t val)
+    void set_sky_light(const nnm::Vector3i pos, const uint8_t val)
     {
         nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(pos);
-        VV_DEB_ASSERT(m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y }), "[WorldData] Invalid chunk");
-        m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).set_lighting(pos, val);
+        VV_DEB_ASSERT(m_chunk_columns.contains(chunk_pos), "[WorldData] Invalid chunk");
+        m_chunk_columns.at(chunk_pos)->set_sky_light(pos, val);
     }
 
     [[nodiscard]] std::optional<uint8_t> lighting_at(const nnm::Vector3i block_pos) const
@@ -47,22 +49,23 @@ public:
         if (chunk_pos.z < -10 || chunk_pos.z >= 10) {
             return {};
         }
-        if (!m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y })) {
+        const ChunkColumn* column = find_column(chunk_pos);
+        if (column == nullptr) {
             return {};
         }
-        return m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).lighting_at(block_pos);
+        return column->lighting_at(block_pos);
     }
 
     [[nodiscard]] uint8_t block_at_local(nnm::Vector3i chunk_pos, const nnm::Vector3i block_pos) const
     {
         VV_DEB_ASSERT(contains_chunk(chunk_pos), "[WorldData] Invalid chunk")
-        return m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).get_block(block_pos);
+        return m_chunk_columns.at(chunk_pos)->get_block(block_local_to_world(chunk_pos, block_pos));
     }
 
     [[nodiscard]] uint8_t lighting_at_local(nnm::Vector3i chunk_pos, const nnm::Vector3i block_pos) const
     {
         VV_DEB_ASSERT(contains_chunk(chunk_pos), "[WorldData] Invalid chunk")
-        return m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).lighting_at(block_pos);
+        return m_chunk_columns.at(chunk_pos)->lighting_at(block_local_to_world(chunk_pos, block_pos));
     }
 
     [[nodiscard]] std::optional<uint8_t> block_at_relative(
@@ -86,45 +89,60 @@ public:
     void set_block(const nnm::Vector3i block_pos, const uint8_t type)
     {
         nnm::Vector3i chunk_pos = chunk_pos_from_block_pos(block_pos);
-        VV_DEB_ASSERT(m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y }), "[WorldData] Invalid chunk");
-        m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).set_block(block_pos, type);
+        VV_DEB_ASSERT(m_chunk_columns.contains(chunk_pos), "[WorldData] Invalid chunk");
+        m_chunk_columns.at(chunk_pos)->set_block(block_pos, type);
         queue_save_chunk({ chunk_pos.x, chunk_pos.y });
     }
 
     void set_block_local(nnm::Vector3i chunk_pos, const nnm::Vector3i block_pos, const uint8_t type)
     {
-        VV_DEB_ASSERT(m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y }), "[WorldData] Invalid chunk");
-        m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).set_block(block_local_to_world(chunk_pos, block_pos), type);
+        VV_DEB_ASSERT(m_chunk_columns.contains(chunk_pos), "[WorldData] Invalid chunk");
+        m_chunk_columns.at(chunk_pos)->set_block(block_local_to_world(chunk_pos, block_pos), type);
         queue_save_chunk({ chunk_pos.x, chunk_pos.y });
     }
 
     ChunkColumn& chunk_column_data_at(const nnm::Vector2i chunk_pos)
     {
         VV_DEB_ASSERT(m_chunk_columns.contains(chunk_pos), "[WorldData] Invalid chunk");
-        return m_chunk_columns.at(chunk_pos);
+        return *m_chunk_columns.at(chunk_pos);
     }
 
     [[nodiscard]] const ChunkColumn& chunk_column_data_at(const nnm::Vector2i chunk_pos) const
     {
         VV_DEB_ASSERT(m_chunk_columns.contains(chunk_pos), "[WorldData] Invalid chunk");
-        return m_chunk_columns.at(chunk_pos);
+        return *m_chunk_columns.at(chunk_pos);
     }
 
     [[nodiscard]] const ChunkData& chunk_data_at(nnm::Vector3i chunk_pos) const
     {
-        VV_DEB_ASSERT(m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y }), "[WorldData] Invalid chunk");
-        return m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).chunk_data_at(chunk_pos);
+        VV_DEB_ASSERT(m_chunk_columns.contains(chunk_pos), "[WorldData] Invalid chunk");
+        return m_chunk_columns.at(chunk_pos)->chunk_data_at(chunk_pos);
     }
 
     ChunkData& chunk_data_at(nnm::Vector3i chunk_pos)
     {
-        VV_DEB_ASSERT(m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y }), "[WorldData] Invalid chunk");
-        return m_chunk_columns.at({ chunk_pos.x, chunk_pos.y }).chunk_data_at(chunk_pos);
+        VV_DEB_ASSERT(m_chunk_columns.contains(chunk_pos), "[WorldData] Invalid chunk");
+        return m_chunk_columns.at(chunk_pos)->chunk_data_at(chunk_pos);
+    }
+
+    // Pointers to columns stay valid until the column is culled or removed
+    template <typename Lookup>
+    [[nodiscard]] ChunkColumn* find_column(const Lookup& chunk_pos)
+    {
+        ChunkColumn* const* column = m_chunk_columns.find(chunk_pos);
+        return column != nullptr ? *column : nullptr;
+    }
+
+    template <typename Lookup>
+    [[nodiscard]] const ChunkColumn* find_column(const Lookup& chunk_pos) const
+    {
+        ChunkColumn* const* column = m_chunk_columns.find(chunk_pos);
+        return column != nullptr ? *column : nullptr;
     }
 
     [[nodiscard]] bool contains_chunk(nnm::Vector3i chunk_pos) const
     {
-        return chunk_pos.z >= -10 && chunk_pos.z < 10 && m_chunk_columns.contains({ chunk_pos.x, chunk_pos.y });
+        return chunk_pos.z >= -10 && chunk_pos.z < 10 && m_chunk_columns.contains(chunk_pos);
     }
 
     [[nodiscard]] bool contains_column(const nnm::Vector2i col_pos) const
@@ -157,7 +175,8 @@ private:
     std::set<nnm::Vector2i> m_save_queue;
     SaveFile m_save;
     nnm::Vector2i m_player_chunk;
-    std::unordered_map<nnm::Vector2i, ChunkColumn> m_chunk_columns {};
+    ChunkColumnPool m_column_pool;
+    ChunkMap<nnm::Vector2i, ChunkColumn*> m_chunk_columns {};
     std::vector<nnm::Vector2i> m_sorted_chunks {};
 
     std::function<bool(nnm::Vector2i, nnm::Vector2i)> compare_from_player
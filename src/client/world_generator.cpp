@@ -3,7 +3,6 @@
 #include <FastNoiseLite.h>
 
 #include "common.hpp"
-#include "lighting.hpp"
 #include "world_data.hpp"
 #include <game_performance_profiler.hpp>
 WorldGenerator::WorldGenerator(int seed)
@@ -29,15 +28,22 @@ void WorldGenerator::generate_chunk(WorldData& world_data, const nnm::Vector2i c
         }
     }
     for_2d({ -1, -1 }, { 2, 2 }, [&](const nnm::Vector2i offset) { generate_trees(world_data, chunk_pos + offset); });
-    ChunkColumn& column = world_data.chunk_column_data_at(chunk_pos);
-    apply_sunlight(column);
-    // for (int h = -10; h < 10; ++h) {
-    //     world_data.propagate_light({ chunk_pos.x, chunk_pos.y, h });
-    // }
-    column.set_gen_level(ChunkColumn::GenLevel::generated);
+    world_data.chunk_column_data_at(chunk_pos).set_gen_level(ChunkColumn::GenLevel::generated);
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
+float WorldGenerator::terrain_height(const nnm::Vector2i block_pos) const
+{
+    constexpr nnm::Vector2 scale_oct1 { 0.5f, 1.0f };
+    constexpr nnm::Vector2 scale_oct2 { 1.0f, 1.0f };
+    constexpr nnm::Vector2 scale_oct3 { 3.0f, 1.0f };
+    const nnm::Vector2 noise_pos { static_cast<float>(block_pos.x), static_cast<float>(block_pos.y) };
+    const float height_oct1 = m_noise_oct1->GetNoise(noise_pos.x * scale_oct1.x, noise_pos.y * scale_oct1.x) * 32.0f;
+    const float height_oct2 = m_noise_oct2->GetNoise(noise_pos.x * scale_oct2.x, noise_pos.y * scale_oct2.x) * 32.0f;
+    const float height_oct3 = m_noise_oct3->GetNoise(noise_pos.x * scale_oct3.x, noise_pos.y * scale_oct3.x) * 32.0f;
+    return 1.0f * height_oct1 + 0.5f * height_oct2 + 0.2f * height_oct3;
+}
+
 void WorldGenerator::generate_terrain(ChunkColumn& data, nnm::Vector2i chunk_pos) const
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
@@ -46,22 +52,9 @@ void WorldGenerator::generate_terrain(ChunkColumn& data, nnm::Vector2i chunk_pos
         return;
     }
     std::array<std::array<float, 16>, 16> heights {};
-
     for (int x = 0; x < 16; x++) {
         for (int y = 0; y < 16; y++) {
-            constexpr nnm::Vector2 scale_oct1 { 0.5f, 1.0f };
-            constexpr nnm::Vector2 scale_oct2 { 1.0f, 1.0f };
-            constexpr nnm::Vector2 scale_oct3 { 3.0f, 1.0f };
-            const nnm::Vector2 noise_pos { static_cast<float>(x + chunk_pos.x * 16),
-                                           static_cast<float>(y + chunk_pos.y * 16) };
-            const float height_oct1
-                = m_noise_oct1->GetNoise(noise_pos.x * scale_oct1.x, noise_pos.y * scale_oct1.x) * 32.0f;
-            const float height_oct2
-                = m_noise_oct2->GetNoise(noise_pos.x * scale_oct2.x, noise_pos.y * scale_oct2.x) * 32.0f;
-            const float height_oct3
-                = m_noise_oct3->GetNoise(noise_pos.x * scale_oct3.x, noise_pos.y * scale_oct3.x) * 32.0f;
-            const float height = 1.0f * height_oct1 + 0.5f * height_oct2 + 0.2f * height_oct3;
-            heights[x][y] = height;
+            heights[x][y] = terrain_height({ x + chunk_pos.x * 16, y + chunk_pos.y * 16 });
         }
     }
 
@@ -106,7 +99,8 @@ void WorldGenerator::generate_trees(WorldData& world_data, nnm::Vector2i chunk_p
     }
     std::array<std::array<int, 16>, 16> heights {};
     for_2d({ 0, 0 }, { 16, 16 }, [&](const nnm::Vector2i pos) {
-        for (int h = 9 * 16; h > -10 * 16; h--) {
+        // Grass is usually the highest opaque block unless a neighbour's tree overhangs the block column
+        for (int h = std::min(column.highest_opaque_height(pos), 9 * 16); h > -10 * 16; h--) {
             if (column.get_block(nnm::Vector3i(chunk_pos.x * 16 + pos.x, chunk_pos.y * 16 + pos.y, h)) == 1) {
                 heights[pos.x][pos.y] = h;
                 PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
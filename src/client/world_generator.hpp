@@ -18,8 +18,14 @@ class WorldGenerator {
 public:
     explicit WorldGenerator(int seed);
 
+    // Generates the blocks of the column, which needs the terrain of the neighbouring columns for trees. The column is
+    // left unlit, light spreads across columns so it is lit afterwards with LightScheduler or relight_columns.
     void generate_chunk(WorldData& world_data, nnm::Vector2i chunk_pos) const;
 
+    // Height of the terrain surface at a block column before trees, blocks below it are solid. Only reads the noise so
+    // it is safe to call from any thread.
+    [[nodiscard]] float terrain_height(nnm::Vector2i block_pos) const;
+
 private:
     void generate_terrain(ChunkColumn& data, nnm::Vector2i chunk_pos) const;
 
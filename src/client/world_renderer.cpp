@@ -1,20 +1,30 @@
 #include "world_renderer.hpp"
 
+#include <algorithm>
+#include <ranges>
+
 #include "common.hpp"
+#include "world_data.hpp"
 
 #include <game_performance_profiler.hpp>
 #include <nnm/nnm.hpp>
 
-void WorldRenderer::push_mesh_update(nnm::Vector3i chunk_pos)
+void WorldRenderer::push_mesh_update(nnm::Vector3i chunk_pos, const MeshUpdateKind kind, const ChunkLod& lod)
 {
-    if (m_chunk_mesh_lookup.contains(chunk_pos)) {
-        m_chunk_buffers.at(m_chunk_mesh_lookup.at(chunk_pos)).reset();
-    }
-    else {
-        m_chunk_mesh_lookup.insert({ chunk_pos, m_chunk_buffers.size() });
+    if (auto [index, inserted] = m_chunk_mesh_lookup.try_emplace(chunk_pos, m_chunk_buffers.size()); inserted) {
+        m_draw_order.push_back({ .chunk_pos = chunk_pos, .slot = m_chunk_buffers.size(), .distance_sqrd = 0 });
+        m_is_draw_order_dirty = true;
         m_chunk_buffers.emplace_back();
     }
-    m_chunk_mesh_update_list.push_back(chunk_pos);
+    // A newer generation makes an update of the chunk that is still pending skipped when it reaches the top of the heap
+    const uint64_t generation = ++m_last_mesh_generation;
+    m_mesh_generations[chunk_pos] = generation;
+    m_pending_mesh_updates.push_back({ .chunk_pos = chunk_pos,
+                                       .generation = generation,
+                                       .kind = kind,
+                                       .lod = lod,
+                                       .priority = mesh_priority(chunk_pos) });
+    std::ranges::push_heap(m_pending_mesh_updates, is_less_urgent);
 }
 
 WorldRenderer::WorldRenderer(mve::Renderer& renderer)
@@ -22,38 +32,48 @@ WorldRenderer::WorldRenderer(mve::Renderer& renderer)
     , m_vertex_shader(mve::Shader(res_path("bin/shader/simple.vert.spv")))
     , m_fragment_shader(mve::Shader(res_path("bin/shader/simple.frag.spv")))
     , m_graphics_pipeline(renderer.create_graphics_pipeline(m_vertex_shader, m_fragment_shader, vertex_layout(), true))
+    , m_translucent_fragment_shader(mve::Shader(res_path("bin/shader/translucent.frag.spv")))
+    , m_translucent_pipeline(
+          renderer.create_graphics_pipeline(m_vertex_shader, m_translucent_fragment_shader, vertex_layout(), true))
+    , m_color_vertex_shader(mve::Shader(res_path("bin/shader/color.vert.spv")))
+    , m_color_fragment_shader(mve::Shader(res_path("bin/shader/color.frag.spv")))
+    , m_color_pipeline(renderer.create_graphics_pipeline(
+          m_color_vertex_shader, m_color_fragment_shader, WireBoxMesh::vertex_layout(), true))
     , m_block_texture(std::make_shared<mve::Texture>(renderer, res_path("atlas.png")))
     , m_global_ubo(renderer.create_uniform_buffer(m_vertex_shader.descriptor_set(0).binding(0)))
-    , m_chunk_ubo(renderer.create_uniform_buffer(m_vertex_shader.descriptor_set(1).binding(0)))
     , m_global_descriptor_set(renderer.create_descriptor_set(m_graphics_pipeline, m_vertex_shader.descriptor_set(0)))
-    , m_chunk_descriptor_set(m_graphics_pipeline.create_descriptor_set(m_vertex_shader.descriptor_set(1)))
+    , m_color_global_descriptor_set(
+          renderer.create_descriptor_set(m_color_pipeline, m_color_vertex_shader.descriptor_set(0)))
     , m_view_location(m_vertex_shader.descriptor_set(0).binding(0).member("view").location())
     , m_proj_location(m_vertex_shader.descriptor_set(0).binding(0).member("proj").location())
     , m_selection_box(SelectionBox {
           .is_shown = true,
           .mesh = WireBoxMesh(
               renderer,
-              m_graphics_pipeline,
-              m_vertex_shader.descriptor_set(1),
-              m_vertex_shader.descriptor_set(1).binding(0),
+              m_color_pipeline,
+              m_color_vertex_shader.descriptor_set(1),
+              m_color_vertex_shader.descriptor_set(1).binding(0),
               BoundingBox { .min = { -0.5f, -0.5f, -0.5f }, .max = { 0.5f, 0.5f, 0.5f } },
               0.01f,
               { 0.0f, 0.0f, 0.0f }) })
 {
     m_global_descriptor_set.write_binding(m_vertex_shader.descriptor_set(0).binding(0), m_global_ubo);
     m_global_descriptor_set.write_binding(m_fragment_shader.descriptor_set(0).binding(1), *m_block_texture);
-    m_chunk_ubo.update(
-        m_vertex_shader.descriptor_set(1).binding(0).member("model").location(), nnm::Matrix4f::identity());
-    m_chunk_ubo.update(m_vertex_shader.descriptor_set(1).binding(0).member("fog_influence").location(), 1.0f);
-    m_chunk_descriptor_set.write_binding(m_vertex_shader.descriptor_set(1).binding(0), m_chunk_ubo);
+    // Both pipelines share the global uniform buffer, their GlobalUniform blocks are identical
+    m_color_global_descriptor_set.write_binding(m_color_vertex_shader.descriptor_set(0).binding(0), m_global_ubo);
     m_frustum = {};
     m_selection_box.mesh.set_position({ 0, 0, 0 });
 
     m_global_ubo.update(
         m_vertex_shader.descriptor_set(0).binding(0).member("fog_color").location(),
         nnm::Vector4(142.0f / 255.0f, 186.0f / 255.0f, 1.0f, 1.0f));
-    m_global_ubo.update(m_vertex_shader.descriptor_set(0).binding(0).member("fog_near").location(), 400.0f);
-    m_global_ubo.update(m_vertex_shader.descriptor_set(0).binding(0).member("fog_far").location(), 475.0f);
+    set_fog_distance(400.0f, 475.0f);
+}
+
+WorldRenderer::~WorldRenderer()
+{
+    // Jobs still running write to the mesh pool and completion queue which are destroyed before the thread pool
+    m_thread_pool.wait();
 }
 
 void WorldRenderer::resize()
@@ -79,24 +99,43 @@ void WorldRenderer::draw(const Player& camera)
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     m_frustum.update_camera(camera);
 
-    m_renderer->bind_graphics_pipeline(m_graphics_pipeline);
+    sort_draw_order(chunk_pos_from_block_pos(camera.block_position()));
 
-    if (m_selection_box.is_shown) {
-        m_selection_box.mesh.draw(m_global_descriptor_set);
-    }
-
-    for (const std::optional<ChunkBuffers>& mesh : m_chunk_buffers) {
+    // Front to back so nearer chunks fill the depth buffer first and hidden faces further away fail the depth test
+    // before shading
+    m_renderer->bind_graphics_pipeline(m_graphics_pipeline);
+    for (const DrawOrderEntry& entry : m_draw_order) {
         // TODO: Fix frustum culling
         // if (mesh.has_value() && m_frustum.contains_sphere(nnm::Vector3f(mesh->chunk_pos()) * 16.0f, 30.0f)) {
-        if (mesh.has_value()) {
-            m_renderer->bind_descriptor_sets(m_global_descriptor_set, m_chunk_descriptor_set);
-            mesh->draw(*m_renderer);
+        if (const std::optional<ChunkBuffers>& mesh = m_chunk_buffers[entry.slot];
+            mesh.has_value() && mesh->has_opaque()) {
+            mesh->draw_opaque(*m_renderer, m_global_descriptor_set);
         }
     }
 
+    // Translucent faces after every opaque face. Leaves, the only translucent block so far, are alpha tested by
+    // discarding their empty texels and need no order, back to front only matters once a texture has partial alpha
+    m_renderer->bind_graphics_pipeline(m_translucent_pipeline);
+    for (const DrawOrderEntry& entry : std::views::reverse(m_draw_order)) {
+        if (const std::optional<ChunkBuffers>& mesh = m_chunk_buffers[entry.slot];
+            mesh.has_value() && mesh->has_translucent()) {
+            mesh->draw_translucent(*m_renderer, m_global_descriptor_set);
+        }
+    }
+
+    m_renderer->bind_graphics_pipeline(m_color_pipeline);
+
+    for (const auto& [_, region] : m_far_regions) {
+        region.draw(*m_renderer, m_color_global_descriptor_set);
+    }
+
+    if (m_selection_box.is_shown) {
+        m_selection_box.mesh.draw(m_color_global_descriptor_set);
+    }
+
     for (const auto& [id, box] : m_debug_boxes) {
         if (box.is_shown) {
-            box.mesh.draw(m_global_descriptor_set);
+            box.mesh.draw(m_color_global_descriptor_set);
         }
     }
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
@@ -120,8 +159,117 @@ bool WorldRenderer::contains_data(const nnm::Vector3i position) const
 }
 void WorldRenderer::remove_data(const nnm::Vector3i position)
 {
-    m_chunk_buffers.at(m_chunk_mesh_lookup.at(position)).reset();
+    const size_t slot = m_chunk_mesh_lookup.at(position);
+    m_chunk_buffers.at(slot).reset();
     m_chunk_mesh_lookup.erase(position);
+    m_mesh_generations.erase(position);
+    // Swapping in the last entry breaks the order, it is sorted again before the next draw
+    const auto entry = std::ranges::find(m_draw_order, slot, &DrawOrderEntry::slot);
+    VV_DEB_ASSERT(entry != m_draw_order.end(), "[WorldRenderer] Removed chunk has no draw order entry")
+    *entry = m_draw_order.back();
+    m_draw_order.pop_back();
+    m_is_draw_order_dirty = true;
+}
+
+void WorldRenderer::sort_draw_order(const nnm::Vector3i camera_chunk)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    const auto begin_time = std::chrono::steady_clock::now();
+    const bool is_resort = camera_chunk != m_draw_order_chunk || m_is_draw_order_dirty;
+    if (is_resort) {
+        m_draw_order_chunk = camera_chunk;
+        m_is_draw_order_dirty = false;
+        for (DrawOrderEntry& entry : m_draw_order) {
+            entry.distance_sqrd = (entry.chunk_pos - camera_chunk).length_sqrd();
+        }
+        // Entries only move a little when the camera crosses one chunk, but streaming appends whole columns at the
+        // edge and removals swap entries from the back, which an insertion sort handles in quadratic time
+        std::ranges::sort(m_draw_order, {}, &DrawOrderEntry::distance_sqrd);
+    }
+    m_last_draw_sort_time = std::chrono::steady_clock::now() - begin_time;
+    if (is_resort) {
+        m_last_draw_resort_time = m_last_draw_sort_time;
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void WorldRenderer::push_far_region(const FarRegionMeshData& mesh_data)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    m_far_regions.erase(mesh_data.region_pos);
+    m_far_regions.try_emplace(
+        mesh_data.region_pos,
+        *m_renderer,
+        m_color_pipeline,
+        m_color_vertex_shader.descriptor_set(1),
+        m_color_vertex_shader.descriptor_set(1).binding(0),
+        mesh_data);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void WorldRenderer::remove_far_region(const nnm::Vector2i region_pos)
+{
+    m_far_regions.erase(region_pos);
+}
+
+void WorldRenderer::set_fog_distance(const float near, const float far)
+{
+    m_global_ubo.update(m_vertex_shader.descriptor_set(0).binding(0).member("fog_near").location(), near);
+    m_global_ubo.update(m_vertex_shader.descriptor_set(0).binding(0).member("fog_far").location(), far);
+}
+
+void WorldRenderer::set_mesh_focus(const nnm::Vector3f position, const nnm::Vector3f direction)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    m_mesh_focus_position = position;
+    m_mesh_focus_direction = direction;
+    // Reordering is linear in the pending updates so it waits until the order has changed noticeably
+    constexpr float reprioritize_cos_angle = 0.97f;
+    if (const nnm::Vector3i focus_chunk = chunk_pos_from_block_pos(nnm::Vector3i(position.round()));
+        focus_chunk != m_prioritized_focus_chunk
+        || direction.dot(m_prioritized_focus_direction) < reprioritize_cos_angle) {
+        m_prioritized_focus_chunk = focus_chunk;
+        m_prioritized_focus_direction = direction;
+        reprioritize_mesh_updates();
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+float WorldRenderer::mesh_priority(const nnm::Vector3i chunk_pos) const
+{
+    // Chunks straight behind the player wait as long as chunks this many times further away in front of them
+    constexpr float behind_distance_scale = 4.0f;
+    const nnm::Vector3f to_chunk = nnm::Vector3f(chunk_pos) * 16.0f + nnm::Vector3f::all(7.5f) - m_mesh_focus_position;
+    const float distance = to_chunk.length();
+    // The chunks the player is in or next to are needed whichever way they face
+    if (distance < 16.0f) {
+        return distance;
+    }
+    const float facing = m_mesh_focus_direction.dot(to_chunk / distance);
+    return distance * (1.0f + (1.0f - facing) * (behind_distance_scale - 1.0f) / 2.0f);
+}
+
+bool WorldRenderer::is_less_urgent(const PendingMeshUpdate& a, const PendingMeshUpdate& b)
+{
+    if (a.kind != b.kind) {
+        return a.kind < b.kind;
+    }
+    return a.priority > b.priority;
+}
+
+void WorldRenderer::reprioritize_mesh_updates()
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    // Superseded updates are dropped here rather than rescored
+    std::erase_if(m_pending_mesh_updates, [&](const PendingMeshUpdate& update) {
+        const uint64_t* generation = m_mesh_generations.find(update.chunk_pos);
+        return generation == nullptr || *generation != update.generation;
+    });
+    for (PendingMeshUpdate& update : m_pending_mesh_updates) {
+        update.priority = mesh_priority(update.chunk_pos);
+    }
+    std::ranges::make_heap(m_pending_mesh_updates, is_less_urgent);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
 
 uint64_t WorldRenderer::create_debug_box(const BoundingBox& box, const float width, const nnm::Vector3f color)
@@ -129,9 +277,9 @@ uint64_t WorldRenderer::create_debug_box(const BoundingBox& box, const float wid
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
     WireBoxMesh box_mesh(
         *m_renderer,
-        m_graphics_pipeline,
-        m_vertex_shader.descriptor_set(1),
-        m_vertex_shader.descriptor_set(1).binding(0),
+        m_color_pipeline,
+        m_color_vertex_shader.descriptor_set(1),
+        m_color_vertex_shader.descriptor_set(1).binding(0),
         box,
         width,
         color);
@@ -167,26 +315,98 @@ void WorldRenderer::delete_all_debug_boxes()
 void WorldRenderer::process_mesh_updates(const WorldData& world_data)
 {
     PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-    std::erase_if(m_chunk_mesh_update_list, [&](const nnm::Vector3i& chunk_pos) {
-        PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
-        return !m_chunk_mesh_lookup.contains(chunk_pos);
-    });
-    m_temp_chunk_buffer_data.clear();
-    m_temp_chunk_buffer_data.resize(m_chunk_mesh_update_list.size());
-    const BS::multi_future<void> tasks = m_thread_pool.submit_blocks<size_t>(
-        0, m_chunk_mesh_update_list.size(), [&](const auto begin, const auto end) {
-            for (auto i = begin; i < end; ++i) {
-                const nnm::Vector3i chunk_pos = m_chunk_mesh_update_list[i];
-                m_temp_chunk_buffer_data[i] = std::move(create_chunk_buffer_data(chunk_pos, world_data));
-            }
+    // Finished jobs are collected first so their slots can be refilled this frame
+    upload_completed_meshes();
+    submit_mesh_jobs(world_data);
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void WorldRenderer::submit_mesh_jobs(const WorldData& world_data)
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    // Enough jobs to keep every worker busy until the next frame while the rest stay in the heap where they can still
+    // be reordered
+    const size_t max_in_flight = m_thread_pool.get_thread_count() * 2;
+    while (m_mesh_jobs_in_flight < max_in_flight && !m_pending_mesh_updates.empty()) {
+        std::ranges::pop_heap(m_pending_mesh_updates, is_less_urgent);
+        const PendingMeshUpdate update = m_pending_mesh_updates.back();
+        m_pending_mesh_updates.pop_back();
+
+        // Skips updates of chunks that were removed or pushed again since
+        if (const uint64_t* generation = m_mesh_generations.find(update.chunk_pos);
+            generation == nullptr || *generation != update.generation) {
+            continue;
+        }
+        if (world_data.chunk_data_at(update.chunk_pos).block_count() == 0) {
+            // Nothing to mesh, this also makes any job still in flight for the chunk stale
+            m_chunk_buffers[m_chunk_mesh_lookup.at(update.chunk_pos)].reset();
+            m_mesh_generations.erase(update.chunk_pos);
+            continue;
+        }
+        MeshJob* job;
+        if (m_free_mesh_jobs.empty()) {
+            job = m_mesh_jobs.emplace_back(std::make_unique<MeshJob>()).get();
+        }
+        else {
+            job = m_free_mesh_jobs.back();
+            m_free_mesh_jobs.pop_back();
+        }
+        job->generation = update.generation;
+        job->mode = lod_meshing_mode(update.lod, m_meshing_mode);
+        job->lod = update.lod;
+        // The snapshot is taken here on the main thread so workers never read WorldData while it is being modified,
+        // already at the level of detail so its apron holds the same cells the neighbours mesh
+        job->neighborhood.emplace(world_data, update.chunk_pos, update.lod.level);
+        ++m_mesh_jobs_in_flight;
+        m_thread_pool.detach_task([this, job] {
+            // Applied before the cache lookup so the key covers the skirts
+            apply_chunk_lod(*job->neighborhood, job->lod);
+            job->result = m_mesh_cache.get_or_create(*job->neighborhood, m_mesh_pool, job->mode);
+            m_completed_mesh_jobs.push(job);
         });
-    tasks.wait();
-    for (const std::optional<ChunkBufferData>& buffer_data : m_temp_chunk_buffer_data) {
-        if (buffer_data.has_value()) {
-            ChunkBuffers buffers(*m_renderer, buffer_data.value());
-            m_chunk_buffers[m_chunk_mesh_lookup[buffers.chunk_pos()]] = std::move(buffers);
+    }
+    PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+}
+
+void WorldRenderer::upload_completed_meshes()
+{
+    PROFILE_START(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
+    for (MeshJob* job = m_completed_mesh_jobs.pop_all(); job != nullptr; job = job->next) {
+        m_ready_mesh_jobs.push_back(job);
+        --m_mesh_jobs_in_flight;
+    }
+    const auto begin_time = std::chrono::steady_clock::now();
+    size_t ready_index = 0;
+    for (; ready_index < m_ready_mesh_jobs.size(); ++ready_index) {
+        if (ready_index > 0 && std::chrono::steady_clock::now() - begin_time >= m_mesh_upload_budget) {
+            break;
+        }
+        MeshJob* job = m_ready_mesh_jobs[ready_index];
+        const nnm::Vector3i chunk_pos = job->neighborhood->chunk_pos();
+        if (const uint64_t* generation = m_mesh_generations.find(chunk_pos);
+            generation != nullptr && *generation == job->generation) {
+            m_mesh_generations.erase(chunk_pos);
+            std::optional<ChunkBuffers>& buffers = m_chunk_buffers[m_chunk_mesh_lookup.at(chunk_pos)];
+            if (job->result.has_value()) {
+                buffers.emplace(
+                    *m_renderer,
+                    m_graphics_pipeline,
+                    m_vertex_shader.descriptor_set(1),
+                    m_vertex_shader.descriptor_set(1).binding(0),
+                    *job->result);
+            }
+            else {
+                buffers.reset();
+            }
+        }
+        if (job->result.has_value()) {
+            // The mesh is on the GPU now or stale, either way its storage can be reused by the next mesh
+            m_mesh_pool.release(std::move(*job->result));
+            job->result.reset();
         }
+        job->neighborhood.reset();
+        m_free_mesh_jobs.push_back(job);
     }
-    m_chunk_mesh_update_list.clear();
+    m_ready_mesh_jobs.erase(m_ready_mesh_jobs.begin(), m_ready_mesh_jobs.begin() + static_cast<ptrdiff_t>(ready_index));
     PROFILE_STOP(std::string("VOXELVERSE:") + ":" + __FUNCTION__)
 }
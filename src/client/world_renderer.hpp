@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <unordered_map>
 
 #include <BS_thread_pool.hpp>
@@ -8,23 +10,111 @@
 
 #include <nnm/nnm.hpp>
 
+#include "chunk_buffers.hpp"
+#include "chunk_map.hpp"
 #include "chunk_mesh.hpp"
+#include "chunk_mesh_cache.hpp"
+#include "chunk_mesh_pool.hpp"
+#include "chunk_neighborhood.hpp"
+#include "far_terrain_mesh.hpp"
 #include "frustum.hpp"
+#include "mpsc_queue.hpp"
 #include "player.hpp"
 #include "wire_box_mesh.hpp"
 
+// From least to most urgent
+enum class MeshUpdateKind {
+    // The chunk moved to another level of detail, its current mesh stays drawn until the new one is uploaded so it
+    // waits for every streaming update
+    lod,
+    // The chunk came into range or needs a full remesh, scheduled by distance and view angle
+    streaming,
+    // A block edit changed the chunk, scheduled before every streaming update so edits show up immediately
+    edit
+};
+
 class WorldRenderer {
 public:
     explicit WorldRenderer(mve::Renderer& renderer);
 
-    void push_mesh_update(nnm::Vector3i chunk_pos);
+    WorldRenderer(const WorldRenderer&) = delete;
+    WorldRenderer& operator=(const WorldRenderer&) = delete;
+
+    ~WorldRenderer();
+
+    // The chunk keeps its current mesh until the new one is uploaded. Pushing a chunk that is already waiting replaces
+    // its earlier update. The chunk is meshed at the given level of detail.
+    void push_mesh_update(
+        nnm::Vector3i chunk_pos, MeshUpdateKind kind = MeshUpdateKind::streaming, const ChunkLod& lod = {});
 
+    // Snapshots the most urgent pending chunks and meshes them on the thread pool without waiting, keeping only a few
+    // jobs per worker in flight so the order stays meaningful, then uploads meshes that finished since the last call
+    // until the upload budget is spent. Meshes of chunks that were pushed again or removed after their job was
+    // submitted are stale and dropped.
     void process_mesh_updates(const WorldData& world_data);
 
+    // Mesh jobs only read their snapshot, so other work on the pool may modify WorldData while they run
+    [[nodiscard]] BS::thread_pool& thread_pool()
+    {
+        return m_thread_pool;
+    }
+
+    void set_mesh_cache_max_memory(const size_t max_memory)
+    {
+        m_mesh_cache.set_max_memory(max_memory);
+    }
+
+    [[nodiscard]] ChunkMeshCache::Stats mesh_cache_stats() const
+    {
+        return m_mesh_cache.stats();
+    }
+
+    // Position and view direction that pending mesh updates are prioritised around, pending updates are reordered
+    // when the player moves to another chunk or turns
+    void set_mesh_focus(nnm::Vector3f position, nnm::Vector3f direction);
+
+    // Time per frame spent uploading finished meshes, at least one mesh is uploaded per frame regardless
+    void set_mesh_upload_budget(const std::chrono::microseconds budget)
+    {
+        m_mesh_upload_budget = budget;
+    }
+
+    // Applies to meshes created after the change, existing meshes need to be queued again
+    void set_meshing_mode(const MeshingMode mode)
+    {
+        m_meshing_mode = mode;
+    }
+
+    [[nodiscard]] MeshingMode meshing_mode() const
+    {
+        return m_meshing_mode;
+    }
+
     bool contains_data(nnm::Vector3i position) const;
 
     void remove_data(nnm::Vector3i position);
 
+    // Replaces the far terrain mesh of the region, drawn with the colour pipeline after the chunks
+    void push_far_region(const FarRegionMeshData& mesh_data);
+
+    void remove_far_region(nnm::Vector2i region_pos);
+
+    // Distances from the camera in blocks where fog starts and where it hides everything
+    void set_fog_distance(float near, float far);
+
+    // Time draw spent ordering chunks last frame, next to nothing unless the camera entered another chunk or chunks
+    // were added
+    [[nodiscard]] std::chrono::nanoseconds last_draw_sort_time() const
+    {
+        return m_last_draw_sort_time;
+    }
+
+    // Time of the most recent frame that reordered chunks
+    [[nodiscard]] std::chrono::nanoseconds last_draw_resort_time() const
+    {
+        return m_last_draw_resort_time;
+    }
+
     void set_view(const nnm::Matrix4f& view);
 
     void resize();
@@ -45,12 +135,7 @@ public:
 
     static mve::VertexLayout vertex_layout()
     {
-        return {
-            mve::VertexAttributeType::vec3, // Position
-            mve::VertexAttributeType::vec3, // Color
-            mve::VertexAttributeType::vec2, // UV
-            mve::VertexAttributeType::scalar // Lighting
-        };
+        return mve::vertex_layout<PackedChunkVertex>();
     }
 
     uint64_t create_debug_box(const BoundingBox& box, float width, nnm::Vector3f color);
@@ -74,6 +159,49 @@ private:
         WireBoxMesh mesh;
     };
 
+    // Meshing of one chunk on the thread pool, reused once its result is uploaded or dropped
+    struct MeshJob {
+        MeshJob* next = nullptr;
+        uint64_t generation = 0;
+        MeshingMode mode = MeshingMode::naive;
+        ChunkLod lod;
+        std::optional<ChunkNeighborhood> neighborhood;
+        std::optional<ChunkBufferData> result;
+    };
+
+    // Chunk mesh slot in draw order
+    struct DrawOrderEntry {
+        nnm::Vector3i chunk_pos;
+        size_t slot;
+        // From the camera's chunk in chunks
+        int distance_sqrd;
+    };
+
+    // Mesh update waiting in m_pending_mesh_updates to be submitted
+    struct PendingMeshUpdate {
+        nnm::Vector3i chunk_pos;
+        uint64_t generation;
+        MeshUpdateKind kind;
+        ChunkLod lod;
+        // Lower is more urgent
+        float priority;
+    };
+
+    [[nodiscard]] float mesh_priority(nnm::Vector3i chunk_pos) const;
+
+    // Heap order of m_pending_mesh_updates with the most urgent update on top
+    [[nodiscard]] static bool is_less_urgent(const PendingMeshUpdate& a, const PendingMeshUpdate& b);
+
+    void reprioritize_mesh_updates();
+
+    void submit_mesh_jobs(const WorldData& world_data);
+
+    void upload_completed_meshes();
+
+    // Sorts m_draw_order nearest first when the camera entered another chunk or slots were added or removed since the
+    // last sort
+    void sort_draw_order(nnm::Vector3i camera_chunk);
+
     // void rebuild_mesh_lookup();
 
     mve::Renderer* m_renderer;
@@ -81,18 +209,50 @@ private:
     mve::Shader m_vertex_shader;
     mve::Shader m_fragment_shader;
     mve::GraphicsPipeline m_graphics_pipeline;
+    // Same vertex stage and bindings as m_graphics_pipeline so chunk and global descriptor sets work with both
+    mve::Shader m_translucent_fragment_shader;
+    mve::GraphicsPipeline m_translucent_pipeline;
+    // Untextured pipeline for the selection and debug boxes
+    mve::Shader m_color_vertex_shader;
+    mve::Shader m_color_fragment_shader;
+    mve::GraphicsPipeline m_color_pipeline;
     std::shared_ptr<mve::Texture> m_block_texture;
     mve::UniformBuffer m_global_ubo;
-    mve::UniformBuffer m_chunk_ubo;
     mve::DescriptorSet m_global_descriptor_set;
-    mve::DescriptorSet m_chunk_descriptor_set;
+    mve::DescriptorSet m_color_global_descriptor_set;
     mve::UniformLocation m_view_location;
     mve::UniformLocation m_proj_location;
-    std::vector<std::optional<ChunkBufferData>> m_temp_chunk_buffer_data {};
-    std::unordered_map<nnm::Vector3i, size_t> m_chunk_mesh_lookup {};
+    ChunkMeshPool m_mesh_pool {};
+    ChunkMeshCache m_mesh_cache {};
+    std::vector<std::unique_ptr<MeshJob>> m_mesh_jobs {};
+    std::vector<MeshJob*> m_free_mesh_jobs {};
+    MpscQueue<MeshJob> m_completed_mesh_jobs {};
+    // Completed jobs that did not fit in the upload budget, oldest first
+    std::vector<MeshJob*> m_ready_mesh_jobs {};
+    // Generation of the newest update pushed for each chunk, pending updates and results of any other generation are
+    // stale
+    ChunkMap<nnm::Vector3i, uint64_t> m_mesh_generations {};
+    uint64_t m_last_mesh_generation = 0;
+    // Binary heap ordered by is_less_urgent
+    std::vector<PendingMeshUpdate> m_pending_mesh_updates {};
+    size_t m_mesh_jobs_in_flight = 0;
+    nnm::Vector3f m_mesh_focus_position;
+    nnm::Vector3f m_mesh_focus_direction { 0.0f, 1.0f, 0.0f };
+    // Focus the pending priorities were computed with
+    nnm::Vector3i m_prioritized_focus_chunk;
+    nnm::Vector3f m_prioritized_focus_direction { 0.0f, 1.0f, 0.0f };
+    std::chrono::microseconds m_mesh_upload_budget { 2000 };
+    ChunkMap<nnm::Vector3i, size_t> m_chunk_mesh_lookup {};
     std::vector<std::optional<ChunkBuffers>> m_chunk_buffers {};
+    // Every slot of m_chunk_buffers, opaque faces are drawn in this order and translucent faces in reverse
+    std::vector<DrawOrderEntry> m_draw_order {};
+    nnm::Vector3i m_draw_order_chunk;
+    bool m_is_draw_order_dirty = false;
+    std::chrono::nanoseconds m_last_draw_sort_time {};
+    std::chrono::nanoseconds m_last_draw_resort_time {};
+    ChunkMap<nnm::Vector2i, FarRegionBuffers> m_far_regions {};
     Frustum m_frustum;
     SelectionBox m_selection_box;
     std::unordered_map<uint64_t, DebugBox> m_debug_boxes {};
-    std::vector<nnm::Vector3i> m_chunk_mesh_update_list {};
+    MeshingMode m_meshing_mode = MeshingMode::naive;
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+// Reads are native order, the reference hash is defined on little endian input
+static_assert(std::endian::native == std::endian::little, "xxh64 assumes a little endian target");
+
+namespace detail {
+
+inline constexpr uint64_t sc_xxh64_prime_1 = 0x9E3779B185EBCA87ull;
+inline constexpr uint64_t sc_xxh64_prime_2 = 0xC2B2AE3D27D4EB4Full;
+inline constexpr uint64_t sc_xxh64_prime_3 = 0x165667B19E3779F9ull;
+inline constexpr uint64_t sc_xxh64_prime_4 = 0x85EBCA77C2B2AE63ull;
+inline constexpr uint64_t sc_xxh64_prime_5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t read_u64(const std::byte* data)
+{
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t read_u32(const std::byte* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t xxh64_round(uint64_t acc, const uint64_t input)
+{
+    acc += input * sc_xxh64_prime_2;
+    acc = std::rotl(acc, 31);
+    return acc * sc_xxh64_prime_1;
+}
+
+inline uint64_t xxh64_merge_round(uint64_t acc, const uint64_t value)
+{
+    acc ^= xxh64_round(0, value);
+    return acc * sc_xxh64_prime_1 + sc_xxh64_prime_4;
+}
+
+}
+
+// XXH64 of data, matches the reference xxHash implementation. Fast non-cryptographic hash for content keys.
+[[nodiscard]] inline uint64_t xxh64(const std::span<const std::byte> data, const uint64_t seed = 0)
+{
+    using namespace detail;
+    const std::byte* ptr = data.data();
+    const std::byte* const end = ptr + data.size();
+    uint64_t hash;
+    if (data.size() >= 32) {
+        uint64_t v1 = seed + sc_xxh64_prime_1 + sc_xxh64_prime_2;
+        uint64_t v2 = seed + sc_xxh64_prime_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - sc_xxh64_prime_1;
+        for (; end - ptr >= 32; ptr += 32) {
+            v1 = xxh64_round(v1, read_u64(ptr));
+            v2 = xxh64_round(v2, read_u64(ptr + 8));
+            v3 = xxh64_round(v3, read_u64(ptr + 16));
+            v4 = xxh64_round(v4, read_u64(ptr + 24));
+        }
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = xxh64_merge_round(hash, v1);
+        hash = xxh64_merge_round(hash, v2);
+        hash = xxh64_merge_round(hash, v3);
+        hash = xxh64_merge_round(hash, v4);
+    }
+    else {
+        hash = seed + sc_xxh64_prime_5;
+    }
+    hash += data.size();
+
+    for (; end - ptr >= 8; ptr += 8) {
+        hash ^= xxh64_round(0, read_u64(ptr));
+        hash = std::rotl(hash, 27) * sc_xxh64_prime_1 + sc_xxh64_prime_4;
+    }
+    if (end - ptr >= 4) {
+        hash ^= read_u32(ptr) * sc_xxh64_prime_1;
+        hash = std::rotl(hash, 23) * sc_xxh64_prime_2 + sc_xxh64_prime_3;
+        ptr += 4;
+    }
+    for (; ptr < end; ++ptr) {
+        hash ^= static_cast<uint64_t>(*ptr) * sc_xxh64_prime_5;
+        hash = std::rotl(hash, 11) * sc_xxh64_prime_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= sc_xxh64_prime_2;
+    hash ^= hash >> 29;
+    hash *= sc_xxh64_prime_3;
+    hash ^= hash >> 32;
+    return hash;
+}
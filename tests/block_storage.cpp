@@ -0,0 +1,122 @@
+#include <catch_amalgamated.hpp>
+
+#include <sstream>
+
+#include <cereal/archives/portable_binary.hpp>
+
+#include "client/block_storage.hpp"
+
+TEST_CASE("BlockStorage frees the index array when filled", "[block_storage]")
+{
+    BlockStorage storage;
+    const size_t uniform_usage = storage.memory_usage();
+    for (size_t i = 0; i < BlockStorage::sc_volume; i += 3) {
+        storage.set(i, static_cast<uint8_t>(1 + i % 5));
+    }
+    REQUIRE(storage.bits_per_block() == 4);
+    REQUIRE(storage.memory_usage() > uniform_usage);
+
+    storage.fill(2);
+    CHECK(storage.is_uniform());
+    CHECK(storage.get(100) == 2);
+    // The palette may keep a few bytes of spare capacity but the index words are gone
+    CHECK(storage.memory_usage() < uniform_usage + 64);
+}
+
+TEST_CASE("BlockStorage shrinks lazily at width boundaries", "[block_storage]")
+{
+    // Air and four other types, one more than fits in 2 bits
+    BlockStorage storage;
+    for (size_t i = 0; i < 4; ++i) {
+        storage.set(i, static_cast<uint8_t>(1 + i));
+    }
+    REQUIRE(storage.bits_per_block() == 4);
+
+    // Toggling the fifth type in and out must not re-pack back and forth between 2 and 4 bits
+    for (int n = 0; n < 4; ++n) {
+        storage.set(3, 0);
+        CHECK(storage.bits_per_block() == 4);
+        storage.set(3, 4);
+        CHECK(storage.bits_per_block() == 4);
+    }
+
+    // Once the palette fits twice over in a narrower width it is shrunk
+    storage.set(3, 0);
+    storage.set(2, 0);
+    CHECK(storage.bits_per_block() == 4);
+    storage.set(1, 0);
+    CHECK(storage.bits_per_block() == 2);
+    CHECK(storage.get(0) == 1);
+    CHECK(storage.get(1) == 0);
+
+    // Going back to a single type always frees the index array
+    storage.set(0, 0);
+    CHECK(storage.is_uniform());
+    CHECK(storage.get(0) == 0);
+}
+
+TEST_CASE("BlockStorage saves compacted", "[block_storage]")
+{
+    BlockStorage storage;
+    for (size_t i = 0; i < 5; ++i) {
+        storage.set(i * 7, static_cast<uint8_t>(1 + i));
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        storage.set(i * 7, 0);
+    }
+    REQUIRE(storage.bits_per_block() == 4);
+
+    std::stringstream stream;
+    {
+        cereal::PortableBinaryOutputArchive archive(stream);
+        archive(storage);
+    }
+    BlockStorage loaded;
+    {
+        cereal::PortableBinaryInputArchive archive(stream);
+        archive(loaded);
+    }
+    CHECK(loaded.bits_per_block() == 2);
+    CHECK(loaded.palette_size() == 3);
+    for (size_t i = 0; i < BlockStorage::sc_volume; ++i) {
+        REQUIRE(loaded.get(i) == storage.get(i));
+    }
+}
+
+TEST_CASE("BlockStorage rejects invalid saved data", "[block_storage]")
+{
+    std::vector<uint8_t> palette { 0, 1 };
+    std::vector<uint16_t> counts { BlockStorage::sc_volume, 0 };
+    std::vector<uint64_t> words(BlockStorage::sc_volume / 64, 0);
+    uint8_t bits = 1;
+
+    SECTION("bits per block")
+    {
+        bits = 3;
+    }
+    SECTION("index array size")
+    {
+        words.pop_back();
+    }
+    SECTION("palette index")
+    {
+        palette.push_back(2);
+        counts.push_back(0);
+        words.resize(words.size() * 2);
+        bits = 2;
+        words[5] = 3;
+    }
+    SECTION("counts")
+    {
+        counts[0]--;
+    }
+
+    std::stringstream stream;
+    {
+        cereal::PortableBinaryOutputArchive archive(stream);
+        archive(palette, counts, words, bits);
+    }
+    BlockStorage storage;
+    cereal::PortableBinaryInputArchive archive(stream);
+    CHECK_THROWS_AS(archive(storage), cereal::Exception);
+}
@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <memory>
+
+#include <catch_amalgamated.hpp>
+
+#include "client/block_registry.hpp"
+#include "client/chunk_column.hpp"
+#include "client/common.hpp"
+#include "client/save_file.hpp"
+#include "client/world_data.hpp"
+#include "test_world.hpp"
+
+#include <nnm/nnm.hpp>
+
+TEST_CASE("ChunkColumn heightmap is saved with the column", "[chunk_column]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_test_world(1);
+    const ChunkColumn& column = world_data->chunk_column_data_at({ 0, 0 });
+    SaveFile save_file(16 * 1024 * 1024, "chunk_column_test");
+    save_file.begin_batch();
+    save_file.insert<nnm::Vector2i, ChunkColumn>(column.pos(), column);
+    save_file.submit_batch();
+
+    const auto loaded = std::make_unique<ChunkColumn>();
+    REQUIRE(save_file.read_into(column.pos(), *loaded));
+    CHECK(loaded->heightmap() == column.heightmap());
+    // The saved heightmap has to match the blocks, not just round trip
+    for_2d({ 0, 0 }, { 16, 16 }, [&](const nnm::Vector2i local_col) {
+        int height = ChunkColumn::sc_no_opaque_height;
+        for (int z = 10 * 16 - 1; z > ChunkColumn::sc_no_opaque_height; --z) {
+            if (light_opacity(loaded->get_block({ local_col.x, local_col.y, z })) != 0) {
+                height = z;
+                break;
+            }
+        }
+        CAPTURE(local_col.x, local_col.y);
+        CHECK(loaded->highest_opaque_height(local_col) == height);
+    });
+}
+
+namespace {
+// Column header written by a save with another format version
+struct StaleColumn {
+    nnm::Vector2i pos;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(ChunkColumn::sc_save_version - 1, pos);
+    }
+};
+}
+
+TEST_CASE("ChunkColumn saved with another version is generated again", "[chunk_column]")
+{
+    // The world saves its columns when destroyed
+    generate_test_world(0).reset();
+    {
+        SaveFile save_file(16 * 1024 * 1024, "world_data");
+        save_file.insert<nnm::Vector2i, StaleColumn>({ 0, 0 }, StaleColumn { { 0, 0 } });
+    }
+
+    WorldData world_data;
+    world_data.create_or_load_chunk({ 0, 0 });
+    CHECK(world_data.chunk_column_data_at({ 0, 0 }).gen_level() == ChunkColumn::none);
+}
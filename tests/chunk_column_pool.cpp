@@ -0,0 +1,29 @@
+#include <catch_amalgamated.hpp>
+
+#include "client/chunk_column.hpp"
+#include "client/chunk_column_pool.hpp"
+#include "client/common.hpp"
+
+#include <nnm/nnm.hpp>
+
+TEST_CASE("ChunkColumnPool frees per-voxel arrays on release", "[chunk_column_pool]")
+{
+    ChunkColumnPool pool;
+    ChunkColumn* column = pool.acquire({ 0, 0 });
+    const size_t empty_usage = column->memory_usage();
+
+    // Mixed blocks and light in every chunk so each allocates its block indices and light array
+    for_3d({ 0, 0, -160 }, { 16, 16, 160 }, [&](const nnm::Vector3i pos) {
+        if ((pos.x + pos.y + pos.z) % 3 == 0) {
+            column->set_block(pos, static_cast<uint8_t>(1 + (pos.x + pos.z) % 4));
+        }
+        if (pos.x == pos.y) {
+            column->set_sky_light(pos, 15);
+        }
+    });
+    REQUIRE(column->memory_usage() > empty_usage + 20 * 16 * 16 * 16);
+
+    pool.release(column);
+    // Slots stay valid after release, only the small palettes of every chunk may keep spare capacity
+    CHECK(column->memory_usage() < empty_usage + 20 * 64);
+}
@@ -0,0 +1,420 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+#include "client/chunk_data.hpp"
+#include "client/chunk_mesh.hpp"
+#include "client/chunk_mesh_pool.hpp"
+#include "client/chunk_neighborhood.hpp"
+#include "client/chunk_vertex.hpp"
+#include "client/common.hpp"
+#include "client/lighting.hpp"
+#include "client/world_data.hpp"
+#include "test_world.hpp"
+
+#include <nnm/nnm.hpp>
+
+namespace {
+
+// Block position and Direction of a face
+using Face = std::array<int, 4>;
+
+// Faces found the way the mesher did before the bitmask path, by visiting every voxel and looking up each of its six
+// neighbours. A non-air block has a face towards an air, transparent or missing neighbour.
+std::vector<Face> per_voxel_faces(const WorldData& world_data, const nnm::Vector3i chunk_pos)
+{
+    std::vector<Face> faces;
+    const ChunkData& chunk_data = world_data.chunk_data_at(chunk_pos);
+    for_3d({ 0, 0, 0 }, { 16, 16, 16 }, [&](const nnm::Vector3i local_pos) {
+        if (chunk_data.get_block(local_pos) == 0) {
+            return;
+        }
+        for (int f = 0; f < 6; ++f) {
+            const auto dir = static_cast<Direction>(f);
+            const uint8_t adj_block
+                = world_data.block_at_relative(chunk_pos, local_pos + direction_vector(dir)).value_or(0);
+            if (adj_block == 0 || is_transparent(adj_block)) {
+                faces.push_back({ local_pos.x, local_pos.y, local_pos.z, f });
+            }
+        }
+    });
+    std::ranges::sort(faces);
+    return faces;
+}
+
+// Faces of a naive mesh, every face is its own quad of four consecutive vertices
+std::vector<Face> mesh_faces(const ChunkBufferData& mesh)
+{
+    const std::span<const std::byte> bytes = mesh.vertex_data.bytes();
+    const std::span vertices(
+        reinterpret_cast<const PackedChunkVertex*>(bytes.data()), bytes.size() / sizeof(PackedChunkVertex));
+    std::vector<Face> faces;
+    for (size_t i = 0; i < vertices.size(); i += 4) {
+        nnm::Vector3i min_corner { 16, 16, 16 };
+        nnm::Vector3i max_corner { 0, 0, 0 };
+        for (size_t c = i; c < i + 4; ++c) {
+            const ChunkVertex vertex = unpack_chunk_vertex(vertices[c]);
+            const nnm::Vector3i corner { vertex.x, vertex.y, vertex.z };
+            for (int a = 0; a < 3; ++a) {
+                min_corner[a] = std::min(min_corner[a], corner[a]);
+                max_corner[a] = std::max(max_corner[a], corner[a]);
+            }
+        }
+        const int face = unpack_chunk_vertex(vertices[i]).face;
+        // The corners span the block along the face plane and sit on its side facing dir along the normal
+        const nnm::Vector3i doubled_pos
+            = min_corner + max_corner - nnm::Vector3i(1, 1, 1) - direction_vector(static_cast<Direction>(face));
+        faces.push_back({ doubled_pos.x / 2, doubled_pos.y / 2, doubled_pos.z / 2, face });
+    }
+    std::ranges::sort(faces);
+    return faces;
+}
+
+// Directions facing down and up each axis
+constexpr std::array<std::array<Direction, 2>, 3> sc_axis_directions { { { Direction::left, Direction::right },
+                                                                          { Direction::front, Direction::back },
+                                                                          { Direction::bottom, Direction::top } } };
+
+// Cells of cell_size blocks covered by the faces of a mesh, merged quads are split back into one face per cell
+std::vector<Face> mesh_cell_faces(const ChunkBufferData& mesh, const int cell_size)
+{
+    const std::span<const std::byte> bytes = mesh.vertex_data.bytes();
+    const std::span vertices(
+        reinterpret_cast<const PackedChunkVertex*>(bytes.data()), bytes.size() / sizeof(PackedChunkVertex));
+    std::vector<Face> faces;
+    for (size_t i = 0; i < vertices.size(); i += 4) {
+        nnm::Vector3i min_corner { 16, 16, 16 };
+        nnm::Vector3i max_corner { 0, 0, 0 };
+        for (size_t c = i; c < i + 4; ++c) {
+            const ChunkVertex vertex = unpack_chunk_vertex(vertices[c]);
+            const nnm::Vector3i corner { vertex.x, vertex.y, vertex.z };
+            for (int a = 0; a < 3; ++a) {
+                min_corner[a] = std::min(min_corner[a], corner[a]);
+                max_corner[a] = std::max(max_corner[a], corner[a]);
+            }
+        }
+        const int face = unpack_chunk_vertex(vertices[i]).face;
+        const nnm::Vector3i normal = direction_vector(static_cast<Direction>(face));
+        nnm::Vector3i begin = min_corner / cell_size;
+        nnm::Vector3i end = max_corner / cell_size;
+        for (int a = 0; a < 3; ++a) {
+            // The quad lies on the side of its cells facing the normal
+            if (normal[a] != 0) {
+                begin[a] -= normal[a] > 0 ? 1 : 0;
+                end[a] = begin[a] + 1;
+            }
+        }
+        for_3d(begin, end, [&](const nnm::Vector3i cell) { faces.push_back({ cell.x, cell.y, cell.z, face }); });
+    }
+    std::ranges::sort(faces);
+    return faces;
+}
+
+
+// Smooth lighting of a face the way calc_chunk_face_lighting did before its ring offsets and occlusion were
+// tabulated, kept as a reference for the tabulated version
+std::array<uint8_t, 4> reference_face_lighting(
+    const ChunkNeighborhood& neighborhood, const nnm::Vector3i local_block_pos, const Direction dir)
+{
+    uint8_t base_lighting = 0;
+
+    // format of check_blocks
+    //      0 | 1 | 2
+    //      ---------
+    //      7 |   | 3
+    //      ---------
+    //      6 | 5 | 4
+    std::array<nnm::Vector3i, 8> check_blocks;
+    switch (dir) {
+    case Direction::front:
+        base_lighting = neighborhood.lighting(local_block_pos + nnm::Vector3i(0, -1, 0));
+        check_blocks = { { { -1, -1, 1 }, { 0, -1, 1 }, { 1, -1, 1 }, { 1, -1, 0 },
+                           { 1, -1, -1 }, { 0, -1, -1 }, { -1, -1, -1 }, { -1, -1, 0 } } };
+        break;
+    case Direction::back:
+        base_lighting = neighborhood.lighting(local_block_pos + nnm::Vector3i(0, 1, 0));
+        check_blocks = { { { 1, 1, 1 }, { 0, 1, 1 }, { -1, 1, 1 }, { -1, 1, 0 },
+                           { -1, 1, -1 }, { 0, 1, -1 }, { 1, 1, -1 }, { 1, 1, 0 } } };
+        break;
+    case Direction::left:
+        base_lighting = neighborhood.lighting(local_block_pos + nnm::Vector3i(-1, 0, 0));
+        check_blocks = { { { -1, 1, 1 }, { -1, 0, 1 }, { -1, -1, 1 }, { -1, -1, 0 },
+                           { -1, -1, -1 }, { -1, 0, -1 }, { -1, 1, -1 }, { -1, 1, 0 } } };
+        break;
+    case Direction::right:
+        base_lighting = neighborhood.lighting(local_block_pos + nnm::Vector3i(1, 0, 0));
+        check_blocks = { { { 1, -1, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 1, 1, 0 },
+                           { 1, 1, -1 }, { 1, 0, -1 }, { 1, -1, -1 }, { 1, -1, 0 } } };
+        break;
+    case Direction::top:
+        base_lighting = neighborhood.lighting(local_block_pos + nnm::Vector3i(0, 0, 1));
+        check_blocks = { { { -1, 1, 1 }, { 0, 1, 1 }, { 1, 1, 1 }, { 1, 0, 1 },
+                           { 1, -1, 1 }, { 0, -1, 1 }, { -1, -1, 1 }, { -1, 0, 1 } } };
+        break;
+    case Direction::bottom:
+        base_lighting = neighborhood.lighting(local_block_pos + nnm::Vector3i(0, 0, -1));
+        check_blocks = { { { 1, 1, -1 }, { 0, 1, -1 }, { -1, 1, -1 }, { -1, 0, -1 },
+                           { -1, -1, -1 }, { 0, -1, -1 }, { 1, -1, -1 }, { 1, 0, -1 } } };
+        break;
+    }
+
+    // format of adj_light
+    //      0 | 1 |        | 0 | 1      |   |        |   |
+    //      ---------    ---------    ---------    ---------
+    //      2 | 3 |        | 2 | 3      | 0 | 1    0 | 1 |
+    //      ---------    ---------    ---------    ---------
+    //        |   |        |   |        | 2 | 3    2 | 3 |
+    std::array<std::array<std::optional<int>, 4>, 4> adj_light {
+        { { std::nullopt, std::nullopt, std::nullopt, base_lighting },
+          { std::nullopt, std::nullopt, base_lighting, std::nullopt },
+          { base_lighting, std::nullopt, std::nullopt, std::nullopt },
+          { std::nullopt, base_lighting, std::nullopt, std::nullopt } }
+    };
+    for (size_t i = 0; i < check_blocks.size(); ++i) {
+        const uint8_t check_block = neighborhood.block(local_block_pos + check_blocks[i]);
+        if (check_block == ChunkNeighborhood::sc_missing_block || !is_transparent(check_block)) {
+            continue;
+        }
+        const uint8_t block_light = neighborhood.lighting(local_block_pos + check_blocks[i]);
+        switch (i) {
+        case 0:
+            adj_light[0][0] = block_light;
+            break;
+        case 1:
+            adj_light[0][1] = block_light;
+            adj_light[1][0] = block_light;
+            break;
+        case 2:
+            adj_light[1][1] = block_light;
+            break;
+        case 3:
+            adj_light[1][3] = block_light;
+            adj_light[2][1] = block_light;
+            break;
+        case 4:
+            adj_light[2][3] = block_light;
+            break;
+        case 5:
+            adj_light[2][2] = block_light;
+            adj_light[3][3] = block_light;
+            break;
+        case 6:
+            adj_light[3][2] = block_light;
+            break;
+        default:
+            adj_light[0][2] = block_light;
+            adj_light[3][0] = block_light;
+            break;
+        }
+    }
+
+    auto avg_light_opts = [](const std::array<std::optional<int>, 4>& arr) -> uint8_t {
+        int total = 0;
+        int count = 0;
+        for (const std::optional<int> i : arr) {
+            if (i.has_value()) {
+                total += *i;
+                count++;
+            }
+        }
+        const int val = count == 0 ? 0 : total / count;
+        return static_cast<uint8_t>(nnm::clamp(val * 16, 0, 255));
+    };
+    std::array lighting = { avg_light_opts(adj_light[0]),
+                            avg_light_opts(adj_light[1]),
+                            avg_light_opts(adj_light[2]),
+                            avg_light_opts(adj_light[3]) };
+
+    constexpr float occlusion_factor = 0.8f;
+    const auto occlude = [&](const int corner) {
+        lighting[corner] = static_cast<uint8_t>(static_cast<float>(lighting[corner]) * occlusion_factor);
+    };
+    for (size_t i = 0; i < check_blocks.size(); i++) {
+        const uint8_t check_block = neighborhood.block(local_block_pos + check_blocks[i]);
+        if (check_block == ChunkNeighborhood::sc_missing_block || check_block == 0) {
+            continue;
+        }
+        switch (i) {
+        case 0:
+            occlude(0);
+            break;
+        case 1:
+            occlude(0);
+            occlude(1);
+            break;
+        case 2:
+            occlude(1);
+            break;
+        case 3:
+            occlude(1);
+            occlude(2);
+            break;
+        case 4:
+            occlude(2);
+            break;
+        case 5:
+            occlude(2);
+            occlude(3);
+            break;
+        case 6:
+            occlude(3);
+            break;
+        default:
+            occlude(3);
+            occlude(0);
+            break;
+        }
+    }
+    return lighting;
+}
+
+}
+
+TEST_CASE("Bitmask mesher finds the same faces as the per-voxel mesher", "[chunk_mesh]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_test_world(2);
+    ChunkMeshPool pool;
+    size_t face_count = 0;
+    // Only the inner columns have every neighbour generated
+    for (const nnm::Vector2i col : test_columns_within(1)) {
+        for (int h = -10; h < 10; ++h) {
+            const nnm::Vector3i chunk_pos { col.x, col.y, h };
+            const std::vector<Face> expected = per_voxel_faces(*world_data, chunk_pos);
+            std::optional<ChunkBufferData> mesh = create_chunk_buffer_data(chunk_pos, *world_data, pool);
+            const std::vector<Face> faces = mesh.has_value() ? mesh_faces(*mesh) : std::vector<Face> {};
+            std::vector<Face> missing;
+            std::ranges::set_difference(expected, faces, std::back_inserter(missing));
+            std::vector<Face> extra;
+            std::ranges::set_difference(faces, expected, std::back_inserter(extra));
+            CAPTURE(chunk_pos.x, chunk_pos.y, chunk_pos.z);
+            REQUIRE(missing.empty());
+            REQUIRE(extra.empty());
+            REQUIRE(faces.size() == expected.size());
+            face_count += faces.size();
+            if (mesh.has_value()) {
+                pool.release(std::move(*mesh));
+            }
+        }
+    }
+    // Guards against the terrain generating nothing and the comparison passing trivially
+    CHECK(face_count > 1000);
+}
+
+TEST_CASE("Face lighting matches the per-face reference", "[chunk_mesh]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_test_world(2);
+    relight_columns(*world_data, test_columns_within(1));
+    size_t face_count = 0;
+    size_t occluded_count = 0;
+    for (const nnm::Vector2i col : test_columns_within(1)) {
+        for (int h = -10; h < 10; ++h) {
+            const nnm::Vector3i chunk_pos { col.x, col.y, h };
+            const ChunkNeighborhood neighborhood(*world_data, chunk_pos);
+            for_3d({ 0, 0, 0 }, { 16, 16, 16 }, [&](const nnm::Vector3i local_pos) {
+                if (neighborhood.block(local_pos) == 0) {
+                    return;
+                }
+                for (int f = 0; f < 6; ++f) {
+                    const auto dir = static_cast<Direction>(f);
+                    const uint8_t adj_block = neighborhood.block(local_pos + direction_vector(dir));
+                    if (adj_block != 0 && adj_block != ChunkNeighborhood::sc_missing_block
+                        && !is_transparent(adj_block)) {
+                        continue;
+                    }
+                    const std::array<uint8_t, 4> expected = reference_face_lighting(neighborhood, local_pos, dir);
+                    CAPTURE(chunk_pos.x, chunk_pos.y, chunk_pos.z, local_pos.x, local_pos.y, local_pos.z, f);
+                    REQUIRE(calc_chunk_face_lighting(neighborhood, local_pos, dir) == expected);
+                    face_count++;
+                    const auto [min_light, max_light] = std::ranges::minmax(expected);
+                    occluded_count += min_light != max_light ? 1 : 0;
+                }
+            });
+        }
+    }
+    // Guards against unlit or flat terrain making the comparison pass trivially
+    CHECK(face_count > 1000);
+    CHECK(occluded_count > 100);
+}
+
+TEST_CASE("Chunks at the same level of detail have no cracks between them", "[chunk_mesh]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_test_world(2);
+    ChunkMeshPool pool;
+    auto is_solid = [](const uint8_t block) { return block != 0 && block != ChunkNeighborhood::sc_missing_block; };
+    auto is_see_through = [](const uint8_t block) {
+        return block == ChunkNeighborhood::sc_missing_block || is_transparent(block);
+    };
+    for (int level = 1; level <= sc_max_lod_level; ++level) {
+        const ChunkLod lod { .level = level };
+        const MeshingMode mode = lod_meshing_mode(lod, MeshingMode::greedy);
+        auto cell_faces = [&](const ChunkNeighborhood& neighborhood) {
+            std::optional<ChunkBufferData> mesh = create_chunk_buffer_data(neighborhood, pool, mode);
+            if (!mesh.has_value()) {
+                return std::vector<Face> {};
+            }
+            std::vector<Face> faces = mesh_cell_faces(*mesh, neighborhood.cell_size());
+            pool.release(std::move(*mesh));
+            return faces;
+        };
+        size_t boundary_face_count = 0;
+        size_t missing_face_count = 0;
+        // Every pair of neighbouring chunks within the inner columns, across each axis
+        for (const nnm::Vector2i col : test_columns_within(1)) {
+            for (int h = -10; h < 10; ++h) {
+                const nnm::Vector3i pos { col.x, col.y, h };
+                const ChunkNeighborhood first(*world_data, pos, level);
+                const std::vector<Face> first_faces = cell_faces(first);
+                const int cells = first.grid_size();
+                for (int axis = 0; axis < 3; ++axis) {
+                    nnm::Vector3i step { 0, 0, 0 };
+                    step[axis] = 1;
+                    const nnm::Vector3i next_pos = pos + step;
+                    if (std::abs(next_pos.x) > 1 || std::abs(next_pos.y) > 1 || next_pos.z >= 10) {
+                        continue;
+                    }
+                    const ChunkNeighborhood second(*world_data, next_pos, level);
+                    const std::vector<Face> second_faces = cell_faces(second);
+                    const auto negative = static_cast<int>(sc_axis_directions[axis][0]);
+                    const auto positive = static_cast<int>(sc_axis_directions[axis][1]);
+                    for (int b = 0; b < cells; ++b) {
+                        for (int a = 0; a < cells; ++a) {
+                            nnm::Vector3i first_cell { 0, 0, 0 };
+                            first_cell[(axis + 1) % 3] = a;
+                            first_cell[(axis + 2) % 3] = b;
+                            first_cell[axis] = cells - 1;
+                            nnm::Vector3i second_cell = first_cell;
+                            second_cell[axis] = 0;
+                            const uint8_t first_block = first.block(first_cell);
+                            const uint8_t second_block = second.block(second_cell);
+                            CAPTURE(level, pos.x, pos.y, pos.z, axis, a, b);
+                            // Each apron holds the cell its neighbour meshes
+                            REQUIRE(first.block(first_cell + step) == second_block);
+                            REQUIRE(second.block(second_cell - step) == first_block);
+                            if (is_solid(first_block) && is_see_through(second_block)) {
+                                ++boundary_face_count;
+                                const Face face { first_cell.x, first_cell.y, first_cell.z, positive };
+                                missing_face_count += std::ranges::binary_search(first_faces, face) ? 0 : 1;
+                            }
+                            if (is_solid(second_block) && is_see_through(first_block)) {
+                                ++boundary_face_count;
+                                const Face face { second_cell.x, second_cell.y, second_cell.z, negative };
+                                missing_face_count += std::ranges::binary_search(second_faces, face) ? 0 : 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        CAPTURE(level);
+        CHECK(missing_face_count == 0);
+        // Guards against the terrain having no surface along chunk boundaries and the check passing trivially
+        CHECK(boundary_face_count > 20);
+    }
+}
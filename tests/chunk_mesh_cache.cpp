@@ -0,0 +1,110 @@
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+#include "client/chunk_mesh.hpp"
+#include "client/chunk_mesh_cache.hpp"
+#include "client/chunk_mesh_pool.hpp"
+#include "client/chunk_neighborhood.hpp"
+#include "client/world_data.hpp"
+#include "test_world.hpp"
+
+#include <nnm/nnm.hpp>
+
+namespace {
+
+void require_same_mesh(const std::optional<ChunkBufferData>& mesh, const std::optional<ChunkBufferData>& expected)
+{
+    REQUIRE(mesh.has_value() == expected.has_value());
+    if (!expected.has_value()) {
+        return;
+    }
+    CHECK(mesh->chunk_pos == expected->chunk_pos);
+    const std::span<const std::byte> bytes = mesh->vertex_data.bytes();
+    const std::span<const std::byte> expected_bytes = expected->vertex_data.bytes();
+    CHECK(std::vector(bytes.begin(), bytes.end()) == std::vector(expected_bytes.begin(), expected_bytes.end()));
+    CHECK(mesh->index_data == expected->index_data);
+    CHECK(mesh->opaque_index_count == expected->opaque_index_count);
+}
+
+// Snapshots of the chunks of the origin column that have faces
+std::vector<std::unique_ptr<ChunkNeighborhood>> meshed_neighborhoods(const WorldData& world_data, ChunkMeshPool& pool)
+{
+    std::vector<std::unique_ptr<ChunkNeighborhood>> neighborhoods;
+    for (int h = -10; h < 10; ++h) {
+        auto neighborhood = std::make_unique<ChunkNeighborhood>(world_data, nnm::Vector3i(0, 0, h));
+        if (std::optional<ChunkBufferData> mesh = create_chunk_buffer_data(*neighborhood, pool); mesh.has_value()) {
+            pool.release(std::move(*mesh));
+            neighborhoods.push_back(std::move(neighborhood));
+        }
+    }
+    return neighborhoods;
+}
+
+}
+
+TEST_CASE("ChunkMeshCache hits give the same mesh as meshing", "[chunk_mesh_cache]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_test_world(1);
+    ChunkMeshPool pool;
+    ChunkMeshCache cache;
+    for (int h = -10; h < 10; ++h) {
+        const ChunkNeighborhood neighborhood(*world_data, { 0, 0, h });
+        for (const MeshingMode mode : { MeshingMode::naive, MeshingMode::greedy }) {
+            CAPTURE(h, static_cast<int>(mode));
+            const std::optional<ChunkBufferData> expected = create_chunk_buffer_data(neighborhood, pool, mode);
+            const std::optional<ChunkBufferData> miss = cache.get_or_create(neighborhood, pool, mode);
+            const std::optional<ChunkBufferData> hit = cache.get_or_create(neighborhood, pool, mode);
+            require_same_mesh(miss, expected);
+            require_same_mesh(hit, expected);
+        }
+    }
+    // Every second request is a hit, and chunks with the same content, like all air, share entries
+    const ChunkMeshCache::Stats stats = cache.stats();
+    CHECK(stats.hits + stats.misses == 80);
+    CHECK(stats.hits >= 40);
+    CHECK(stats.memory_usage <= stats.max_memory);
+}
+
+TEST_CASE("ChunkMeshCache evicts least recently used meshes over its limit", "[chunk_mesh_cache]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_test_world(1);
+    ChunkMeshPool pool;
+    const std::vector<std::unique_ptr<ChunkNeighborhood>> neighborhoods = meshed_neighborhoods(*world_data, pool);
+    REQUIRE(neighborhoods.size() >= 3);
+    ChunkMeshCache cache;
+    const auto get = [&](const size_t i, const MeshingMode mode) {
+        std::optional<ChunkBufferData> mesh = cache.get_or_create(*neighborhoods[i], pool, mode);
+        if (mesh.has_value()) {
+            pool.release(std::move(*mesh));
+        }
+    };
+
+    get(0, MeshingMode::naive);
+    get(1, MeshingMode::naive);
+    get(2, MeshingMode::naive);
+    const ChunkMeshCache::Stats full = cache.stats();
+    REQUIRE(full.entry_count == 3);
+    cache.set_max_memory(full.memory_usage);
+    // Makes entry 1 the least recently used, then inserts a greedy mesh which is never larger than the naive one of
+    // the same chunk so it always fits
+    get(0, MeshingMode::naive);
+    get(2, MeshingMode::naive);
+    get(0, MeshingMode::greedy);
+    const ChunkMeshCache::Stats evicted = cache.stats();
+    CHECK(evicted.memory_usage <= evicted.max_memory);
+    CHECK(evicted.entry_count <= 3);
+
+    get(0, MeshingMode::greedy);
+    CHECK(cache.stats().hits == evicted.hits + 1);
+    get(1, MeshingMode::naive);
+    CHECK(cache.stats().misses == evicted.misses + 1);
+    CHECK(cache.stats().memory_usage <= full.memory_usage);
+
+    cache.clear();
+    CHECK(cache.stats().entry_count == 0);
+    CHECK(cache.stats().memory_usage == 0);
+}
@@ -0,0 +1,51 @@
+#include <cstdint>
+
+#include <catch_amalgamated.hpp>
+
+#include "client/chunk_vertex.hpp"
+
+namespace {
+
+// Every field at a value of its own so a field overlapping another one changes both
+constexpr ChunkVertex sc_base_vertex {
+    .x = 1, .y = 2, .z = 3, .face = 4, .corner = 1, .atlas_tile = 6, .light = 7, .quad_width = 8, .quad_height = 9
+};
+
+// Sets field to every value from min to max in turn, with the other fields at the base vertex and at their extremes
+template <typename Setter>
+void check_field_round_trips(const int min, const int max, Setter&& set_field)
+{
+    constexpr ChunkVertex max_vertex { .x = 16,
+                                       .y = 16,
+                                       .z = 16,
+                                       .face = 5,
+                                       .corner = 3,
+                                       .atlas_tile = 15,
+                                       .light = 255,
+                                       .quad_width = 16,
+                                       .quad_height = 16 };
+    constexpr ChunkVertex min_vertex { .quad_width = 1, .quad_height = 1 };
+    for (const ChunkVertex& other_fields : { sc_base_vertex, min_vertex, max_vertex }) {
+        for (int value = min; value <= max; ++value) {
+            ChunkVertex vertex = other_fields;
+            set_field(vertex, static_cast<uint8_t>(value));
+            CAPTURE(value);
+            REQUIRE(unpack_chunk_vertex(pack_chunk_vertex(vertex)) == vertex);
+        }
+    }
+}
+
+}
+
+TEST_CASE("Packed chunk vertices round trip every field over its full range", "[chunk_vertex]")
+{
+    check_field_round_trips(0, 16, [](ChunkVertex& vertex, const uint8_t value) { vertex.x = value; });
+    check_field_round_trips(0, 16, [](ChunkVertex& vertex, const uint8_t value) { vertex.y = value; });
+    check_field_round_trips(0, 16, [](ChunkVertex& vertex, const uint8_t value) { vertex.z = value; });
+    check_field_round_trips(0, 5, [](ChunkVertex& vertex, const uint8_t value) { vertex.face = value; });
+    check_field_round_trips(0, 3, [](ChunkVertex& vertex, const uint8_t value) { vertex.corner = value; });
+    check_field_round_trips(0, 15, [](ChunkVertex& vertex, const uint8_t value) { vertex.atlas_tile = value; });
+    check_field_round_trips(0, 255, [](ChunkVertex& vertex, const uint8_t value) { vertex.light = value; });
+    check_field_round_trips(1, 16, [](ChunkVertex& vertex, const uint8_t value) { vertex.quad_width = value; });
+    check_field_round_trips(1, 16, [](ChunkVertex& vertex, const uint8_t value) { vertex.quad_height = value; });
+}
@@ -0,0 +1,32 @@
+#include <catch_amalgamated.hpp>
+
+#include "client/light_storage.hpp"
+
+TEST_CASE("LightStorage frees the per-voxel array once uniform", "[light_storage]")
+{
+    LightStorage storage;
+    REQUIRE(storage.memory_usage() == 0);
+
+    storage.set_sky(7, 15);
+    REQUIRE_FALSE(storage.is_uniform());
+    REQUIRE(storage.memory_usage() >= LightStorage::sc_volume);
+
+    SECTION("reset")
+    {
+        storage.reset(15, 0);
+        CHECK(storage.is_uniform());
+        CHECK(storage.memory_usage() == 0);
+        CHECK(storage.packed(7) == LightStorage::pack(15, 0));
+    }
+
+    SECTION("fill")
+    {
+        storage.set_block(9, 4);
+        storage.fill_sky(3);
+        CHECK_FALSE(storage.is_uniform());
+        storage.fill_block(0);
+        CHECK(storage.is_uniform());
+        CHECK(storage.memory_usage() == 0);
+        CHECK(storage.packed(9) == LightStorage::pack(3, 0));
+    }
+}
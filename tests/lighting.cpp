@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <BS_thread_pool.hpp>
+#include <catch_amalgamated.hpp>
+
+#include "client/chunk_column.hpp"
+#include "client/chunk_data.hpp"
+#include "client/light_scheduler.hpp"
+#include "client/light_engine.hpp"
+#include "client/lighting.hpp"
+#include "client/world_data.hpp"
+#include "client/world_generator.hpp"
+#include "test_world.hpp"
+
+#include <nnm/nnm.hpp>
+
+namespace {
+
+std::vector<nnm::Vector2i> generated_columns(const WorldData& world_data, const int radius)
+{
+    std::vector<nnm::Vector2i> columns;
+    for (const nnm::Vector2i col : test_columns_within(radius)) {
+        if (world_data.contains_column(col)
+            && world_data.chunk_column_data_at(col).gen_level() == ChunkColumn::generated) {
+            columns.push_back(col);
+        }
+    }
+    return columns;
+}
+
+std::vector<uint8_t> light_of(const WorldData& world_data, const std::vector<nnm::Vector2i>& columns)
+{
+    std::vector<uint8_t> light;
+    for (const nnm::Vector2i col : columns) {
+        for (int h = -10; h < 10; ++h) {
+            const LightStorage& lighting = world_data.chunk_data_at({ col.x, col.y, h }).lighting();
+            for (size_t i = 0; i < 16 * 16 * 16; ++i) {
+                light.push_back(lighting.packed(i));
+            }
+        }
+    }
+    return light;
+}
+
+// Voxels whose light differs from a relight of the columns from scratch, which leaves the columns relit
+size_t count_light_mismatches(WorldData& world_data, const std::vector<nnm::Vector2i>& columns)
+{
+    const std::vector<uint8_t> light = light_of(world_data, columns);
+    relight_columns(world_data, columns);
+    const std::vector<uint8_t> relit_light = light_of(world_data, columns);
+    size_t mismatch_count = 0;
+    for (size_t i = 0; i < light.size(); ++i) {
+        mismatch_count += light[i] != relit_light[i] ? 1 : 0;
+    }
+    return mismatch_count;
+}
+
+// Generates the columns within a radius of 2 and lights them one at a time the way ChunkController streams them in
+std::unique_ptr<WorldData> generate_streamed_test_world()
+{
+    std::unique_ptr<WorldData> world_data = generate_test_world(0);
+    BS::thread_pool thread_pool(2);
+    LightScheduler scheduler(thread_pool);
+    scheduler.relight_columns(*world_data, generated_columns(*world_data, 0));
+    const WorldGenerator generator(sc_test_seed);
+    for (const nnm::Vector2i col : test_columns_within(2)) {
+        if (!world_data->contains_column(col)) {
+            world_data->create_or_load_chunk(col);
+        }
+        if (world_data->chunk_column_data_at(col).gen_level() < ChunkColumn::generated) {
+            generator.generate_chunk(*world_data, col);
+            const std::vector<nnm::Vector2i> new_columns { col };
+            scheduler.light_new_columns(*world_data, new_columns);
+        }
+    }
+    return world_data;
+}
+
+struct BlockEdit {
+    nnm::Vector3i pos;
+    uint8_t block;
+};
+
+// Digging, lamps and leaves around the surface of the columns within a radius of 1, far enough from the edge of a
+// streamed test world that the light they change stays inside it
+std::vector<BlockEdit> random_surface_edits(const WorldGenerator& generator, const int count)
+{
+    constexpr std::array<uint8_t, 4> blocks { 0, 2, 9, 10 };
+    std::mt19937 random(sc_test_seed);
+    std::uniform_int_distribution<int> block_col_dist(-16, 31);
+    std::uniform_int_distribution<int> depth_dist(-12, 6);
+    std::uniform_int_distribution<size_t> block_dist(0, blocks.size() - 1);
+    std::vector<BlockEdit> edits;
+    for (int i = 0; i < count; ++i) {
+        const nnm::Vector2i block_col { block_col_dist(random), block_col_dist(random) };
+        const int surface = static_cast<int>(nnm::ceil(generator.terrain_height(block_col)));
+        edits.push_back({ .pos = { block_col.x, block_col.y, surface + depth_dist(random) },
+                          .block = blocks[block_dist(random)] });
+    }
+    return edits;
+}
+
+}
+
+TEST_CASE("Lighting new columns spreads the light of lit neighbours into them", "[lighting]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_test_world(2);
+    BS::thread_pool thread_pool(2);
+    LightScheduler scheduler(thread_pool);
+    scheduler.relight_columns(*world_data, generated_columns(*world_data, 2));
+
+    // An emitter on the border of the lit area, standing in for one that was saved with its column
+    constexpr nnm::Vector3i emitter_pos { 47, 0, 152 };
+    REQUIRE(world_data->block_at(emitter_pos) == 0);
+    world_data->set_block(emitter_pos, 10);
+    scheduler.relight_columns(*world_data, generated_columns(*world_data, 2));
+
+    const WorldGenerator generator(sc_test_seed);
+    constexpr nnm::Vector2i new_col { 3, 0 };
+    if (!world_data->contains_column(new_col)) {
+        world_data->create_or_load_chunk(new_col);
+    }
+    generator.generate_chunk(*world_data, new_col);
+    const std::vector<nnm::Vector2i> new_columns { new_col };
+    scheduler.light_new_columns(*world_data, new_columns);
+
+    CHECK(world_data->chunk_data_at({ 3, 0, 9 }).block_light_at({ 0, 0, 8 }) == 14);
+    CHECK(count_light_mismatches(*world_data, generated_columns(*world_data, 3)) == 0);
+}
+
+TEST_CASE("Light engine edits match a relight of columns lit as they are generated", "[lighting]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_streamed_test_world();
+    const std::vector<nnm::Vector2i> columns = generated_columns(*world_data, 2);
+    REQUIRE(columns.size() == 25);
+
+    const WorldGenerator generator(sc_test_seed);
+    LightEngine light_engine;
+    for (const auto& [block_pos, block] : random_surface_edits(generator, 200)) {
+        const uint8_t old_block = *world_data->block_at(block_pos);
+        world_data->set_block(block_pos, block);
+        light_engine.update_block(*world_data, block_pos, old_block);
+    }
+    CHECK(count_light_mismatches(*world_data, columns) == 0);
+}
+
+TEST_CASE("Light engine reports the voxels whose light an edit changed", "[lighting]")
+{
+    const std::unique_ptr<WorldData> world_data = generate_streamed_test_world();
+    const std::vector<nnm::Vector2i> columns = generated_columns(*world_data, 2);
+    const WorldGenerator generator(sc_test_seed);
+    LightEngine light_engine;
+    size_t change_count = 0;
+    for (const auto& [block_pos, block] : random_surface_edits(generator, 20)) {
+        const std::vector<uint8_t> light_before = light_of(*world_data, columns);
+        const uint8_t old_block = *world_data->block_at(block_pos);
+        world_data->set_block(block_pos, block);
+        light_engine.update_block(*world_data, block_pos, old_block);
+        const std::vector<uint8_t> light_after = light_of(*world_data, columns);
+
+        std::vector<LightEngine::LightChange> expected;
+        for (size_t i = 0; i < light_before.size(); ++i) {
+            if (light_before[i] == light_after[i]) {
+                continue;
+            }
+            // light_of lays the voxels out column by column and chunk by chunk from the bottom
+            const nnm::Vector2i col = columns[i / (20 * 4096)];
+            const int h = static_cast<int>(i / 4096 % 20) - 10;
+            const auto index = static_cast<int>(i % 4096);
+            expected.push_back({ nnm::Vector3i(col.x, col.y, h) * 16
+                                     + nnm::Vector3i(index % 16, index / 16 % 16, index / 256),
+                                 light_before[i] });
+        }
+        std::vector<LightEngine::LightChange> changes(
+            light_engine.last_update_light_changes().begin(), light_engine.last_update_light_changes().end());
+        auto by_position = [](const LightEngine::LightChange& a, const LightEngine::LightChange& b) {
+            return std::tie(a.block_pos.x, a.block_pos.y, a.block_pos.z, a.packed_light_before)
+                < std::tie(b.block_pos.x, b.block_pos.y, b.block_pos.z, b.packed_light_before);
+        };
+        std::ranges::sort(expected, by_position);
+        std::ranges::sort(changes, by_position);
+        CAPTURE(block_pos.x, block_pos.y, block_pos.z);
+        REQUIRE(changes.size() == expected.size());
+        for (size_t i = 0; i < changes.size(); ++i) {
+            REQUIRE(changes[i].block_pos == expected[i].block_pos);
+            REQUIRE(changes[i].packed_light_before == expected[i].packed_light_before);
+        }
+        change_count += changes.size();
+    }
+    // Guards against the edits changing nothing and the comparison passing trivially
+    CHECK(change_count > 100);
+}
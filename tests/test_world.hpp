@@ -0,0 +1,38 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "client/common.hpp"
+#include "client/world_data.hpp"
+#include "client/world_generator.hpp"
+
+#include <nnm/nnm.hpp>
+
+inline constexpr int sc_test_seed = 1;
+
+inline std::vector<nnm::Vector2i> test_columns_within(const int radius)
+{
+    std::vector<nnm::Vector2i> columns;
+    for_2d({ -radius, -radius }, { radius + 1, radius + 1 }, [&](const nnm::Vector2i pos) { columns.push_back(pos); });
+    return columns;
+}
+
+// Generates every column within radius of the origin with sc_test_seed in a new world. Saves are written relative to
+// the working directory so tests run in a fresh temporary one and never load terrain from an earlier run.
+inline std::unique_ptr<WorldData> generate_test_world(const int radius)
+{
+    const std::filesystem::path work_dir = std::filesystem::temp_directory_path() / "voxelverse_tests";
+    std::filesystem::remove_all(work_dir);
+    std::filesystem::create_directories(work_dir);
+    std::filesystem::current_path(work_dir);
+
+    const WorldGenerator generator(sc_test_seed);
+    auto world_data = std::make_unique<WorldData>();
+    for (const nnm::Vector2i col : test_columns_within(radius)) {
+        world_data->create_or_load_chunk(col);
+        generator.generate_chunk(*world_data, col);
+    }
+    return world_data;
+}